@@ -37,6 +37,7 @@
 
 #include "gbin.h"
 #include "gbinprivate.h"
+#include "gchildprivate.h"
 
 
 enum
@@ -56,6 +57,16 @@ static gboolean	add			(GContainerable	*containerable,
 					 GChildable	*childable);
 static gboolean	remove			(GContainerable	*containerable,
 					 GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+					 GFunc		 func,
+					 gpointer	 user_data);
+static guint *	get_flags		(GContainerable	*containerable);
+static guint	n_children		(GContainerable	*containerable);
+static gboolean	contains		(GContainerable	*containerable,
+					 GChildable	*childable);
+static GChildable *
+		get_nth			(GContainerable	*containerable,
+					 guint		 nth);
 
 
 G_DEFINE_TYPE_EXTENDED (GBin, g_bin, G_TYPE_CHILD, 0, 
@@ -69,6 +80,11 @@ containerable_init (GContainerableIface *iface)
   iface->get_children = get_children;
   iface->add = add;
   iface->remove = remove;
+  iface->foreach = foreach;
+  iface->get_flags = get_flags;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
 }
 
 static void
@@ -154,6 +170,51 @@ remove (GContainerable *containerable,
   return TRUE;
 }
 
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GBin *bin = (GBin *) containerable;
+
+  if (bin->priv->content != NULL)
+    func (bin->priv->content, user_data);
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+static guint
+n_children (GContainerable *containerable)
+{
+  GBin *bin = (GBin *) containerable;
+
+  return bin->priv->content != NULL ? 1 : 0;
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  GBin *bin = (GBin *) containerable;
+
+  return childable != NULL && bin->priv->content == childable;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  GBin *bin = (GBin *) containerable;
+
+  return nth == 0 ? bin->priv->content : NULL;
+}
+
 
 /**
  * g_bin_new:
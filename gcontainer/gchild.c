@@ -35,6 +35,7 @@
 
 #include "gchild.h"
 #include "gchildprivate.h"
+#include "ginstancepool.h"
 
 
 enum
@@ -45,6 +46,7 @@ enum
 
 
 static void	        childable_init	(GChildableIface *iface);
+static void		dispose		(GObject	*object);
 static void             get_property	(GObject	*object,
 					 guint		 prop_id,
 					 GValue		*value,
@@ -56,17 +58,22 @@ static void             set_property	(GObject	*object,
 static GContainerable *	get_parent      (GChildable	*childable);
 static void		set_parent      (GChildable	*childable,
 					 GContainerable	*parent);
+static guint *		get_flags	(GChildable	*childable);
 
 
 G_DEFINE_TYPE_EXTENDED (GChild, g_child, G_TYPE_INITIALLY_UNOWNED, 0, 
                         G_IMPLEMENT_INTERFACE (G_TYPE_CHILDABLE, childable_init));
 
 
+static GInstancePool pool = G_INSTANCE_POOL_INIT;
+
+
 static void
 childable_init (GChildableIface *iface)
 {
   iface->get_parent = get_parent;
   iface->set_parent = set_parent;
+  iface->get_flags = get_flags;
 }
 
 static void
@@ -80,7 +87,7 @@ g_child_class_init (GChildClass *klass)
 
   gobject_class->get_property = get_property;
   gobject_class->set_property = set_property;
-  gobject_class->dispose = g_childable_dispose;
+  gobject_class->dispose = dispose;
 
   g_object_class_override_property (gobject_class, PROP_PARENT, "parent");
 }
@@ -91,6 +98,17 @@ g_child_init (GChild *child)
   child->priv = G_TYPE_INSTANCE_GET_PRIVATE (child, G_TYPE_CHILD,
 					     GChildPrivate);
   child->priv->parent = NULL;
+  child->priv->flags = 0;
+}
+
+static void
+dispose (GObject *object)
+{
+  g_childable_dispose (object);
+
+  /* Subclasses are not pooled: they could have their own state */
+  if (G_OBJECT_TYPE (object) == G_TYPE_CHILD)
+    _g_instance_pool_release (&pool, object);
 }
 
 static void
@@ -135,14 +153,22 @@ set_property (GObject      *object,
 static GContainerable *
 get_parent (GChildable *childable)
 {
-  return ((GChild *) childable)->priv->parent;
+  /* Atomic access, so the parent can be queried while a thread safe
+   * #GContainer is adding or removing this child in another thread */
+  return g_atomic_pointer_get (&((GChild *) childable)->priv->parent);
 }
 
 static void
 set_parent (GChildable     *childable,
 	    GContainerable *parent)
 {
-  ((GChild *) childable)->priv->parent = parent;
+  g_atomic_pointer_set (&((GChild *) childable)->priv->parent, parent);
+}
+
+static guint *
+get_flags (GChildable *childable)
+{
+  return &((GChild *) childable)->priv->flags;
 }
 
 
@@ -156,5 +182,52 @@ set_parent (GChildable     *childable,
 GObject *
 g_child_new (void)
 {
-  return g_object_new (G_TYPE_CHILD, NULL);
+  GObject *object;
+
+  object = _g_instance_pool_acquire (&pool);
+
+  if (object == NULL)
+    return g_object_new (G_TYPE_CHILD, NULL);
+
+  ((GChild *) object)->priv->flags = 0;
+  return object;
+}
+
+/**
+ * g_child_set_pool_limit:
+ * @limit: maximum number of instances to retain, or 0 to disable the pool
+ *
+ * Enables the recycling of #GChild instances. When a #GChild is
+ * released and the pool has room for it, the instance is not finalized
+ * but retained, and given back by the next g_child_new() call without
+ * going through the type system.
+ *
+ * A recycled instance is reset to its initial state: it has no parent,
+ * no signal handlers, no weak references and no data attached with
+ * g_object_set_data() and friends. An instance referenced again while
+ * being released, e.g. through a #GWeakRef, is not pooled.
+ *
+ * Instances of subclasses of #GChild are never pooled. Lowering the
+ * limit finalizes the instances exceeding it. The pool is disabled by
+ * default.
+ **/
+void
+g_child_set_pool_limit (guint limit)
+{
+  _g_instance_pool_set_limit (&pool, limit);
+}
+
+/**
+ * g_child_get_pool_stats:
+ * @stats: where to store the statistics
+ *
+ * Gets the statistics of the #GChild pool.
+ * See g_child_set_pool_limit() for further details.
+ **/
+void
+g_child_get_pool_stats (GInstancePoolStats *stats)
+{
+  g_return_if_fail (stats != NULL);
+
+  _g_instance_pool_get_stats (&pool, stats);
 }
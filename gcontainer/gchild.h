@@ -36,6 +36,7 @@ G_BEGIN_DECLS
 typedef struct _GChild        GChild;
 typedef struct _GChildClass   GChildClass;
 typedef struct _GChildPrivate GChildPrivate;
+typedef struct _GInstancePoolStats GInstancePoolStats;
 
 struct _GChild
 {
@@ -50,10 +51,32 @@ struct _GChildClass
   GInitiallyUnownedClass parent_class;
 };
 
+/**
+ * GInstancePoolStats:
+ * @limit: maximum number of instances retained by the pool
+ * @n_pooled: number of instances currently in the pool
+ * @n_recycled: instances put in the pool instead of being finalized
+ * @n_reused: instances taken from the pool instead of being created
+ * @n_dropped: instances finalized because the pool was full
+ *
+ * Statistics of an instance pool, as returned by g_child_get_pool_stats()
+ * or g_container_get_pool_stats().
+ **/
+struct _GInstancePoolStats
+{
+  guint			 limit;
+  guint			 n_pooled;
+  guint			 n_recycled;
+  guint			 n_reused;
+  guint			 n_dropped;
+};
+
 
 GType		g_child_get_type		(void) G_GNUC_CONST;
 
 GObject *	g_child_new			(void);
+void		g_child_set_pool_limit		(guint		 limit);
+void		g_child_get_pool_stats		(GInstancePoolStats *stats);
 
 G_END_DECLS
 
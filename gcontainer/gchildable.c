@@ -44,9 +44,17 @@
  * @set_parent:		set the new parent.
  * @parent_set:		signal handler for the #GChildable::parent_set
  *			signals.
+ * @get_flags:		returns the location of a #guint reserved to the
+ *			interface for its internal state.
  *
  * The virtual methods @get_parent and @set_parent must be defined
  * by all the types which implement this interface.
+ *
+ * @get_flags is optional but, as it is used on every unparent, it is
+ * worth implementing it by returning a field of the instance private
+ * structure. The default method keeps the flags in the object data.
+ * Objects implementing also #GContainerable must return the same
+ * location from #GContainerableIface.get_flags.
  **/
 
 
@@ -54,9 +62,10 @@
 #include "gcontainerable.h"
 #include "gobjectmissings.h"
 #include "gcontainerintl.h"
+#include "gflagsprivate.h"
+#include "gifacecache.h"
 
-#define G_CHILDABLE_IS_DISPOSING(obj)   ((gboolean) GPOINTER_TO_INT (g_object_get_qdata ((GObject *) (obj), quark_disposing)))
-#define G_CHILDABLE_SET_DISPOSING(obj)  g_object_set_qdata ((GObject *) (obj), quark_disposing, GINT_TO_POINTER ((gint) TRUE))
+#define G_CHILDABLE_FLAGS(iface,obj)	(*(iface)->get_flags ((GChildable *) (obj)))
 
 
 enum
@@ -71,8 +80,9 @@ static void		iface_init	(GChildableIface *iface);
 static GContainerable *	get_parent	(GChildable	*childable);
 static void		set_parent	(GChildable	*childable,
 					 GContainerable	*parent);
+static guint *		get_flags	(GChildable	*childable);
 
-static GQuark		quark_disposing = 0;
+static GQuark		quark_flags = 0;
 static guint		signals[LAST_SIGNAL] = { 0 };
 
 
@@ -110,7 +120,7 @@ iface_base (GChildableIface *iface)
     return;
 
   initialized = TRUE;
-  quark_disposing = g_quark_from_static_string ("gchildable-disposing");
+  quark_flags = g_quark_from_static_string ("gcontainer-flags");
 
   param = g_param_spec_object ("parent",
                                P_("Parent"),
@@ -134,6 +144,8 @@ iface_base (GChildableIface *iface)
                                       NULL, NULL,
                                       g_cclosure_marshal_VOID__OBJECT,
                                       G_TYPE_NONE, 1, G_TYPE_OBJECT);
+  g_signal_set_va_marshaller (signals[PARENT_SET], G_TYPE_CHILDABLE,
+                              g_cclosure_marshal_VOID__OBJECTv);
 }
 
 static void
@@ -141,6 +153,7 @@ iface_init (GChildableIface *iface)
 {
   iface->get_parent = get_parent;
   iface->set_parent = set_parent;
+  iface->get_flags = get_flags;
 }
 
 
@@ -160,6 +173,24 @@ set_parent (GChildable     *childable,
              g_type_name (G_TYPE_FROM_INSTANCE (childable)));
 }
 
+static guint *
+get_flags (GChildable *childable)
+{
+  guint *flags;
+
+  /* The same quark is used by the GContainerable default method */
+  flags = g_object_get_qdata ((GObject *) childable, quark_flags);
+
+  if (flags == NULL)
+    {
+      flags = g_new0 (guint, 1);
+      g_object_set_qdata_full ((GObject *) childable, quark_flags,
+			       flags, g_free);
+    }
+
+  return flags;
+}
+
 
 /**
  * g_childable_get_parent:
@@ -172,9 +203,30 @@ set_parent (GChildable     *childable,
 GContainerable *
 g_childable_get_parent (GChildable *childable)
 {
-  g_return_val_if_fail (G_IS_CHILDABLE (childable), NULL);
+  g_return_val_if_fail (G_IS_CHILDABLE_CACHED (childable), NULL);
 
-  return G_CHILDABLE_GET_IFACE (childable)->get_parent (childable);
+  return G_CHILDABLE_PEEK_IFACE (childable)->get_parent (childable);
+}
+
+/**
+ * g_childable_get_parent_unchecked:
+ * @childable: a #GChildable
+ *
+ * Same as g_childable_get_parent(), but @childable is not validated
+ * unless the library is configured with <option>--enable-debug</option>.
+ * Use it only on objects known to implement #GChildable, such as the
+ * ones got from the iteration of a container.
+ *
+ * Returns: the requested parent
+ **/
+GContainerable *
+g_childable_get_parent_unchecked (GChildable *childable)
+{
+#ifdef GCONTAINER_ENABLE_DEBUG
+  g_return_val_if_fail (G_IS_CHILDABLE_CACHED (childable), NULL);
+#endif
+
+  return G_CHILDABLE_PEEK_IFACE (childable)->get_parent (childable);
 }
 
 /**
@@ -194,10 +246,10 @@ g_childable_set_parent (GChildable     *childable,
   GChildableIface *childable_iface;
   GContainerable  *old_parent;
 
-  g_return_if_fail (G_IS_CHILDABLE (childable));
-  g_return_if_fail (G_IS_CONTAINERABLE (parent));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (parent));
 
-  childable_iface = G_CHILDABLE_GET_IFACE (childable);
+  childable_iface = G_CHILDABLE_PEEK_IFACE (childable);
   old_parent = childable_iface->get_parent (childable);
 
   if (old_parent != NULL)
@@ -226,9 +278,9 @@ g_childable_unparent (GChildable *childable)
   GChildableIface *childable_iface;
   GContainerable  *old_parent;
 
-  g_return_if_fail (G_IS_CHILDABLE (childable));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
 
-  childable_iface = G_CHILDABLE_GET_IFACE (childable);
+  childable_iface = G_CHILDABLE_PEEK_IFACE (childable);
   old_parent = childable_iface->get_parent (childable);
 
   if (old_parent == NULL)
@@ -237,7 +289,7 @@ g_childable_unparent (GChildable *childable)
   childable_iface->set_parent (childable, NULL);
   g_signal_emit (childable, signals[PARENT_SET], 0, old_parent);
 
-  if (!G_CHILDABLE_IS_DISPOSING (childable))
+  if ((G_CHILDABLE_FLAGS (childable_iface, childable) & G_FLAG_DISPOSING) == 0)
     g_object_unref (childable);
 }
 
@@ -256,10 +308,10 @@ g_childable_reparent (GChildable     *childable,
   GChildableIface *childable_iface;
   GContainerable  *old_parent;
 
-  g_return_if_fail (G_IS_CHILDABLE (childable));
-  g_return_if_fail (G_IS_CONTAINERABLE (parent));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (parent));
 
-  childable_iface = G_CHILDABLE_GET_IFACE (childable);
+  childable_iface = G_CHILDABLE_PEEK_IFACE (childable);
   old_parent = childable_iface->get_parent (childable);
 
   g_return_if_fail (old_parent != NULL);
@@ -292,13 +344,14 @@ g_childable_dispose (GObject *object)
   GType            instance_type;
   GObjectClass    *parent_class;
 
-  if (G_CHILDABLE_IS_DISPOSING (object))
+  childable = (GChildable *) object;
+  childable_iface = G_CHILDABLE_PEEK_IFACE (childable);
+
+  if (G_CHILDABLE_FLAGS (childable_iface, childable) & G_FLAG_DISPOSING)
     return;
-      
-  G_CHILDABLE_SET_DISPOSING (object);
 
-  childable = (GChildable *) object;
-  childable_iface = G_CHILDABLE_GET_IFACE (childable);
+  G_CHILDABLE_FLAGS (childable_iface, childable) |= G_FLAG_DISPOSING;
+
   old_parent = childable_iface->get_parent (childable);
   instance_type = G_TYPE_INSTANCE_WHICH_IMPLEMENTS (object, G_TYPE_CHILDABLE);
   parent_class = g_type_class_peek (g_type_parent (instance_type));
@@ -52,12 +52,17 @@ struct _GChildableIface
   /* Signals */
   void                  (*parent_set)           (GChildable     *childable,
                                                  GContainerable *old_parent);
+
+  /* Optional methods */
+  guint *               (*get_flags)            (GChildable     *childable);
 };
 
 
 GType		g_childable_get_type		(void) G_GNUC_CONST;
 
 GContainerable *g_childable_get_parent		(GChildable	*childable);
+GContainerable *g_childable_get_parent_unchecked
+						(GChildable	*childable);
 void		g_childable_set_parent		(GChildable	*childable,
 						 GContainerable	*parent);
 void		g_childable_unparent		(GChildable	*childable);
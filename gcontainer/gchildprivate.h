@@ -28,6 +28,7 @@ G_BEGIN_DECLS
 struct _GChildPrivate
 {
   GContainerable *parent;
+  guint           flags;
 };
 
 
@@ -0,0 +1,592 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:gchunkedcontainer
+ * @short_description: A container packing its children in arrays
+ *
+ * A #GChunkedContainer is a #GContainerable with the same behavior of
+ * #GContainer (the children are kept in the order they were added) but
+ * a different storage, optimized for iteration on large containers.
+ *
+ * #GContainer keeps a list node per child, allocated when the child is
+ * added and so scattered across the heap: walking the children follows
+ * one pointer per child. Here the children are packed in a list of
+ * fixed-size arrays (chunks) instead, so walking them reads memory
+ * sequentially. A chunk is filled before allocating the next one and
+ * adjacent chunks are merged when their children fit in a single one,
+ * so chunks are always more than half full on average.
+ *
+ * Every child is indexed by its chunk, so removing a child needs only
+ * a search inside that chunk, done with vector instructions when
+ * available. The children removed while iterating are
+ * only cleared, and the chunks are compacted when the iteration ends.
+ **/
+
+/**
+ * GChunkedContainer:
+ *
+ * All the fields in the GChunkedContainer structure are private and
+ * should never be accessed directly.
+ **/
+
+#include "gchunkedcontainer.h"
+#include "gchunkedcontainerprivate.h"
+#include "gchildprivate.h"
+#include "gpointersearch.h"
+#include <string.h>
+
+
+enum
+{
+  PROP_0,
+  PROP_CHILD
+};
+
+
+static void	containerable_init	(GContainerableIface *iface);
+static void	finalize		(GObject	*object);
+static void     set_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         const GValue	*value,
+                                         GParamSpec	*pspec);
+static GSList * get_children		(GContainerable	*containerable);
+static gboolean add			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gboolean remove			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+                                         GFunc		 func,
+                                         gpointer	 user_data);
+static gboolean add_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static gboolean remove_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static guint *	get_flags		(GContainerable	*containerable);
+static guint	n_children		(GContainerable	*containerable);
+static gboolean contains		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static GChildable *
+		get_nth			(GContainerable	*containerable,
+                                         guint		 nth);
+static gboolean add_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gboolean remove_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gint	get_position		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	append			(GChunkedContainer *chunked_container,
+                                         GChildable	*childable);
+static guint	position_of		(GChunkedContainer *chunked_container,
+                                         GChunk		*chunk,
+                                         GChildable	*childable);
+static void	take_out		(GChunkedContainer *chunked_container,
+                                         GChunk		*chunk,
+                                         GChildable	*childable);
+static void	merge			(GChunkedContainer *chunked_container,
+                                         GChunk		*chunk);
+static void	compact			(GChunkedContainer *chunked_container);
+static void	unlink_chunk		(GChunkedContainer *chunked_container,
+                                         GChunk		*chunk);
+
+
+G_DEFINE_TYPE_EXTENDED (GChunkedContainer, g_chunked_container, G_TYPE_CHILD, 0, 
+                        G_IMPLEMENT_INTERFACE (G_TYPE_CONTAINERABLE, 
+                                               containerable_init));
+
+
+static void
+containerable_init (GContainerableIface *iface)
+{
+  iface->get_children = get_children;
+  iface->add = add;
+  iface->remove = remove;
+  iface->foreach = foreach;
+  iface->add_many = add_many;
+  iface->remove_many = remove_many;
+  iface->get_flags = get_flags;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
+  iface->add_indexed = add_indexed;
+  iface->remove_indexed = remove_indexed;
+  iface->get_position = get_position;
+}
+
+static void
+g_chunked_container_class_init (GChunkedContainerClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = (GObjectClass *) klass;
+
+  g_type_class_add_private (klass, sizeof (GChunkedContainerPrivate));
+
+  gobject_class->set_property = set_property;
+  gobject_class->dispose = g_containerable_dispose;
+  gobject_class->finalize = finalize;
+
+  g_object_class_override_property (gobject_class, PROP_CHILD, "child");
+}
+
+static void
+g_chunked_container_init (GChunkedContainer *chunked_container)
+{
+  chunked_container->priv = G_TYPE_INSTANCE_GET_PRIVATE (chunked_container,
+							 G_TYPE_CHUNKED_CONTAINER,
+							 GChunkedContainerPrivate);
+  chunked_container->priv->head = NULL;
+  chunked_container->priv->tail = NULL;
+  chunked_container->priv->chunks = g_hash_table_new (NULL, NULL);
+  chunked_container->priv->n_children = 0;
+  chunked_container->priv->iterating = 0;
+  chunked_container->priv->has_holes = FALSE;
+}
+
+static void
+finalize (GObject *object)
+{
+  GChunkedContainer *chunked_container = (GChunkedContainer *) object;
+
+  while (chunked_container->priv->head != NULL)
+    unlink_chunk (chunked_container, chunked_container->priv->head);
+
+  g_hash_table_destroy (chunked_container->priv->chunks);
+
+  G_OBJECT_CLASS (g_chunked_container_parent_class)->finalize (object);
+}
+
+static void
+set_property (GObject      *object,
+	      guint         prop_id,
+	      const GValue *value,
+	      GParamSpec   *pspec)
+{
+  GContainerable *containerable = (GContainerable *) object;
+
+  switch (prop_id)
+    {
+    case PROP_CHILD:
+      g_containerable_add (containerable, g_value_get_object (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+
+static GSList *
+get_children (GContainerable *containerable)
+{
+  GChunkedContainer *chunked_container;
+  GSList            *children;
+  GChunk            *chunk;
+  guint              n;
+
+  chunked_container = (GChunkedContainer *) containerable;
+  children = NULL;
+
+  /* Walking backward allows to build the list by prepending */
+  for (chunk = chunked_container->priv->tail; chunk; chunk = chunk->prev)
+    for (n = chunk->len; n --; )
+      if (chunk->children[n] != NULL)
+	children = g_slist_prepend (children, chunk->children[n]);
+
+  return children;
+}
+
+static gboolean
+add (GContainerable *containerable,
+     GChildable     *childable)
+{
+  return add_indexed (containerable, childable, NULL);
+}
+
+static gboolean
+remove (GContainerable *containerable,
+	GChildable     *childable)
+{
+  return remove_indexed (containerable, childable, NULL);
+}
+
+/* A %NULL @position is accepted for the plain add() and remove() */
+
+static gboolean
+add_indexed (GContainerable *containerable,
+	     GChildable     *childable,
+	     guint          *position)
+{
+  GChunkedContainer *chunked_container;
+
+  chunked_container = (GChunkedContainer *) containerable;
+  append (chunked_container, childable);
+
+  /* The holes are always before the new child */
+  if (position != NULL)
+    *position = chunked_container->priv->n_children - 1;
+
+  return TRUE;
+}
+
+static gboolean
+remove_indexed (GContainerable *containerable,
+		GChildable     *childable,
+		guint          *position)
+{
+  GChunkedContainer *chunked_container;
+  GChunk            *chunk;
+
+  chunked_container = (GChunkedContainer *) containerable;
+  chunk = g_hash_table_lookup (chunked_container->priv->chunks, childable);
+
+  if (chunk == NULL)
+    return FALSE;
+
+  if (position != NULL)
+    *position = position_of (chunked_container, chunk, childable);
+
+  take_out (chunked_container, chunk, childable);
+  return TRUE;
+}
+
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GChunkedContainer *chunked_container;
+  GChildable        *childable;
+  GChunk            *chunk;
+  guint              n;
+
+  chunked_container = (GChunkedContainer *) containerable;
+
+  /* No chunk is freed or shifted while iterating: func() can remove
+   * any child, that is only cleared, and can add new children, that
+   * are appended and visited too */
+  ++ chunked_container->priv->iterating;
+
+  for (chunk = chunked_container->priv->head; chunk; chunk = chunk->next)
+    for (n = 0; n < chunk->len; ++ n)
+      {
+	childable = chunk->children[n];
+
+	if (childable != NULL)
+	  func (childable, user_data);
+      }
+
+  if (-- chunked_container->priv->iterating == 0 &&
+      chunked_container->priv->has_holes)
+    compact (chunked_container);
+}
+
+static gboolean
+add_many (GContainerable *containerable,
+	  guint           n_children,
+	  GChildable    **children)
+{
+  GChunkedContainer *chunked_container;
+  guint              n;
+
+  chunked_container = (GChunkedContainer *) containerable;
+
+  for (n = 0; n < n_children; ++ n)
+    append (chunked_container, children[n]);
+
+  return TRUE;
+}
+
+static gboolean
+remove_many (GContainerable *containerable,
+	     guint           n_children,
+	     GChildable    **children)
+{
+  GChunkedContainer *chunked_container;
+  GChunk            *chunk;
+  guint              n;
+
+  chunked_container = (GChunkedContainer *) containerable;
+
+  /* Check in advance, so nothing is touched if some child is missing */
+  for (n = 0; n < n_children; ++ n)
+    if (!g_hash_table_lookup (chunked_container->priv->chunks, children[n]))
+      return FALSE;
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      chunk = g_hash_table_lookup (chunked_container->priv->chunks, children[n]);
+
+      if (chunk)
+	take_out (chunked_container, chunk, children[n]);
+    }
+
+  return TRUE;
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+static guint
+n_children (GContainerable *containerable)
+{
+  GChunkedContainer *chunked_container = (GChunkedContainer *) containerable;
+
+  return chunked_container->priv->n_children;
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  GChunkedContainer *chunked_container = (GChunkedContainer *) containerable;
+
+  return g_hash_table_lookup (chunked_container->priv->chunks, childable) != NULL;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  GChunkedContainer *chunked_container;
+  GChunk            *chunk;
+  guint              n;
+
+  chunked_container = (GChunkedContainer *) containerable;
+
+  for (chunk = chunked_container->priv->head; chunk; chunk = chunk->next)
+    {
+      /* Whole chunks are skipped, unless some child was cleared */
+      if (!chunked_container->priv->has_holes)
+	{
+	  if (nth < chunk->len)
+	    return chunk->children[nth];
+
+	  nth -= chunk->len;
+	  continue;
+	}
+
+      for (n = 0; n < chunk->len; ++ n)
+	if (chunk->children[n] != NULL && nth -- == 0)
+	  return chunk->children[n];
+    }
+
+  return NULL;
+}
+
+static gint
+get_position (GContainerable *containerable,
+	      GChildable     *childable)
+{
+  GChunkedContainer *chunked_container;
+  GChunk            *chunk;
+
+  chunked_container = (GChunkedContainer *) containerable;
+  chunk = g_hash_table_lookup (chunked_container->priv->chunks, childable);
+
+  return chunk != NULL ? position_of (chunked_container, chunk, childable) : -1;
+}
+
+
+static guint
+position_of (GChunkedContainer *chunked_container,
+	     GChunk            *chunk,
+	     GChildable        *childable)
+{
+  GChunk *other;
+  guint   position, n;
+
+  position = 0;
+
+  /* As in get_nth(), whole chunks are counted unless there are holes */
+  for (other = chunked_container->priv->head; other != chunk; other = other->next)
+    {
+      if (!chunked_container->priv->has_holes)
+	{
+	  position += other->len;
+	  continue;
+	}
+
+      for (n = 0; n < other->len; ++ n)
+	if (other->children[n] != NULL)
+	  ++ position;
+    }
+
+  for (n = 0; chunk->children[n] != childable; ++ n)
+    if (chunk->children[n] != NULL)
+      ++ position;
+
+  return position;
+}
+
+static void
+append (GChunkedContainer *chunked_container,
+	GChildable        *childable)
+{
+  GChunk *chunk;
+
+  chunk = chunked_container->priv->tail;
+
+  if (chunk == NULL || chunk->len == G_CHUNK_SIZE)
+    {
+      chunk = g_slice_new (GChunk);
+      chunk->prev = chunked_container->priv->tail;
+      chunk->next = NULL;
+      chunk->len = 0;
+
+      if (chunk->prev)
+	chunk->prev->next = chunk;
+      else
+	chunked_container->priv->head = chunk;
+
+      chunked_container->priv->tail = chunk;
+    }
+
+  chunk->children[chunk->len ++] = childable;
+  g_hash_table_insert (chunked_container->priv->chunks, childable, chunk);
+  ++ chunked_container->priv->n_children;
+}
+
+static void
+take_out (GChunkedContainer *chunked_container,
+	  GChunk            *chunk,
+	  GChildable        *childable)
+{
+  gint n;
+
+  n = _g_pointer_search ((gconstpointer *) chunk->children, chunk->len, childable);
+  g_return_if_fail (n >= 0);
+
+  g_hash_table_remove (chunked_container->priv->chunks, childable);
+  -- chunked_container->priv->n_children;
+
+  if (chunked_container->priv->iterating > 0)
+    {
+      chunk->children[n] = NULL;
+      chunked_container->priv->has_holes = TRUE;
+      return;
+    }
+
+  -- chunk->len;
+  memmove (chunk->children + n, chunk->children + n + 1,
+	   (chunk->len - n) * sizeof (GChildable *));
+
+  if (chunk->len == 0)
+    {
+      unlink_chunk (chunked_container, chunk);
+      return;
+    }
+
+  if (chunk->prev != NULL && chunk->prev->len + chunk->len <= G_CHUNK_SIZE)
+    merge (chunked_container, chunk->prev);
+  else
+    merge (chunked_container, chunk);
+}
+
+/* Moves the children of the chunk following @chunk into @chunk, if they
+ * fit: adjacent chunks are so always more than one chunk full together.
+ * When @chunk is the merged one, also the next pair is checked. */
+
+static void
+merge (GChunkedContainer *chunked_container,
+       GChunk            *chunk)
+{
+  GChunk *next;
+  guint   n;
+
+  while ((next = chunk->next) != NULL &&
+	 chunk->len + next->len <= G_CHUNK_SIZE)
+    {
+      for (n = 0; n < next->len; ++ n)
+	{
+	  chunk->children[chunk->len ++] = next->children[n];
+	  g_hash_table_insert (chunked_container->priv->chunks,
+			       next->children[n], chunk);
+	}
+
+      unlink_chunk (chunked_container, next);
+    }
+}
+
+static void
+compact (GChunkedContainer *chunked_container)
+{
+  GChunk *chunk, *next;
+  guint   n, len;
+
+  chunked_container->priv->has_holes = FALSE;
+
+  for (chunk = chunked_container->priv->head; chunk; chunk = next)
+    {
+      next = chunk->next;
+      len = 0;
+
+      for (n = 0; n < chunk->len; ++ n)
+	if (chunk->children[n] != NULL)
+	  chunk->children[len ++] = chunk->children[n];
+
+      chunk->len = len;
+
+      if (len == 0)
+	unlink_chunk (chunked_container, chunk);
+    }
+
+  for (chunk = chunked_container->priv->head; chunk; chunk = chunk->next)
+    merge (chunked_container, chunk);
+}
+
+static void
+unlink_chunk (GChunkedContainer *chunked_container,
+	      GChunk            *chunk)
+{
+  if (chunk->prev)
+    chunk->prev->next = chunk->next;
+  else
+    chunked_container->priv->head = chunk->next;
+
+  if (chunk->next)
+    chunk->next->prev = chunk->prev;
+  else
+    chunked_container->priv->tail = chunk->prev;
+
+  g_slice_free (GChunk, chunk);
+}
+
+
+/**
+ * g_chunked_container_new:
+ *
+ * Creates a new container storing its children in arrays.
+ *
+ * Return value: a #GChunkedContainer instance
+ **/
+GObject *
+g_chunked_container_new (void)
+{
+  return g_object_new (G_TYPE_CHUNKED_CONTAINER, NULL);
+}
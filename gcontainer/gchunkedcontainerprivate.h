@@ -0,0 +1,55 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef __G_CHUNKED_CONTAINER_PRIVATE_H__
+#define __G_CHUNKED_CONTAINER_PRIVATE_H__
+
+
+G_BEGIN_DECLS
+
+
+/* 64 pointers: a chunk spans a few cache lines, walked sequentially */
+#define G_CHUNK_SIZE	64
+
+typedef struct _GChunk GChunk;
+
+struct _GChunk
+{
+  GChunk		*prev;
+  GChunk		*next;
+  guint			 len;
+  GChildable		*children[G_CHUNK_SIZE];
+};
+
+struct _GChunkedContainerPrivate
+{
+  GChunk		*head;
+  GChunk		*tail;
+  GHashTable		*chunks;
+  guint			 n_children;
+  guint			 iterating;
+  gboolean		 has_holes;
+};
+
+
+G_END_DECLS
+
+
+#endif /* __G_CHUNKED_CONTAINER_PRIVATE_H__ */
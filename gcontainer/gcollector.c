@@ -0,0 +1,533 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:gcollector
+ * @short_description: A container gathering children from more threads
+ *
+ * A #GCollector is a #GContainerable meant to gather children from more
+ * producer threads at the same time and to hand them to a consumer.
+ *
+ * Producers do not contend with each other nor with the consumers on the
+ * collector itself: the children are kept in a singly linked stack whose
+ * head is updated with a compare-and-exchange, so concurrent producers
+ * only retry on contention. All the other operations (removing,
+ * iterating, g_collector_take_all()) are done by the consumers and are
+ * serialized by a consumer lock that producers never take.
+ *
+ * Adding a child is not lock-free as a whole, though: g_containerable_add()
+ * still sinks the floating reference of the child, sets its parent and
+ * emits the #GContainerable::add signal, and GObject protects these with
+ * its own global locks.
+ *
+ * The children are iterated in the order they were added. As with any
+ * container, a child is added to a #GCollector only once its parent is
+ * not set, and the parent is set after the child is collected: a child
+ * is visible to g_collector_take_all() only when its parent is set.
+ **/
+
+/**
+ * GCollector:
+ *
+ * All the fields in the GCollector structure are private and should never
+ * be accessed directly.
+ **/
+
+#include "gcollector.h"
+#include "gcollectorprivate.h"
+#include "gchildprivate.h"
+
+
+enum
+{
+  PROP_0,
+  PROP_CHILD
+};
+
+
+static void	containerable_init	(GContainerableIface *iface);
+static void	finalize		(GObject	*object);
+static void     set_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         const GValue	*value,
+                                         GParamSpec	*pspec);
+static GSList * get_children		(GContainerable	*containerable);
+static gboolean add			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gboolean remove			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+                                         GFunc		 func,
+                                         gpointer	 user_data);
+static gboolean add_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static gboolean remove_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static guint *	get_flags		(GContainerable	*containerable);
+static void	push			(GCollector	*collector,
+                                         GCollectorNode	*first,
+                                         GCollectorNode	*last);
+static GCollectorNode *
+		detach			(GCollector	*collector);
+static void	restore			(GCollector	*collector,
+                                         GCollectorNode	*list);
+
+
+G_DEFINE_TYPE_EXTENDED (GCollector, g_collector, G_TYPE_CHILD, 0, 
+                        G_IMPLEMENT_INTERFACE (G_TYPE_CONTAINERABLE, 
+                                               containerable_init));
+
+
+static void
+containerable_init (GContainerableIface *iface)
+{
+  iface->get_children = get_children;
+  iface->add = add;
+  iface->remove = remove;
+  iface->foreach = foreach;
+  iface->add_many = add_many;
+  iface->remove_many = remove_many;
+  iface->get_flags = get_flags;
+}
+
+static void
+g_collector_class_init (GCollectorClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = (GObjectClass *) klass;
+
+  g_type_class_add_private (klass, sizeof (GCollectorPrivate));
+
+  gobject_class->set_property = set_property;
+  gobject_class->dispose = g_containerable_dispose;
+  gobject_class->finalize = finalize;
+
+  g_object_class_override_property (gobject_class, PROP_CHILD, "child");
+}
+
+static void
+g_collector_init (GCollector *collector)
+{
+  collector->priv = G_TYPE_INSTANCE_GET_PRIVATE (collector, G_TYPE_COLLECTOR, 
+						 GCollectorPrivate);
+  collector->priv->head = NULL;
+  g_rec_mutex_init (&collector->priv->consumer);
+}
+
+static void
+finalize (GObject *object)
+{
+  GCollector     *collector;
+  GCollectorNode *node, *next;
+
+  collector = (GCollector *) object;
+
+  /* Only the nodes of children whose parent was never set could be
+   * left here, if the collector was released in the middle of an add */
+  for (node = collector->priv->head; node; node = next)
+    {
+      next = node->next;
+      g_slice_free (GCollectorNode, node);
+    }
+
+  g_rec_mutex_clear (&collector->priv->consumer);
+
+  G_OBJECT_CLASS (g_collector_parent_class)->finalize (object);
+}
+
+static void
+set_property (GObject      *object,
+	      guint         prop_id,
+	      const GValue *value,
+	      GParamSpec   *pspec)
+{
+  GContainerable *containerable = (GContainerable *) object;
+
+  switch (prop_id)
+    {
+    case PROP_CHILD:
+      g_containerable_add (containerable, g_value_get_object (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+
+/* The stack is kept from the newest to the oldest child. Producers only
+ * push on top of it. Consumers detach the whole stack, work on it
+ * privately and restore what is left below the children pushed in the
+ * meantime, so the order of addition is preserved: the nodes below the
+ * head are changed only by the consumers, that are serialized. */
+
+static void
+push (GCollector     *collector,
+      GCollectorNode *first,
+      GCollectorNode *last)
+{
+  GCollectorNode *head;
+
+  do
+    {
+      head = g_atomic_pointer_get (&collector->priv->head);
+      last->next = head;
+    }
+  while (!g_atomic_pointer_compare_and_exchange (&collector->priv->head,
+						 head, first));
+}
+
+static GCollectorNode *
+detach (GCollector *collector)
+{
+  GCollectorNode *head;
+
+  do
+    head = g_atomic_pointer_get (&collector->priv->head);
+  while (head != NULL &&
+	 !g_atomic_pointer_compare_and_exchange (&collector->priv->head,
+						 head, NULL));
+
+  return head;
+}
+
+static void
+restore (GCollector     *collector,
+	 GCollectorNode *list)
+{
+  GCollectorNode *head, *node;
+
+  if (list == NULL)
+    return;
+
+  for (;;)
+    {
+      head = g_atomic_pointer_get (&collector->priv->head);
+
+      if (head == NULL)
+	{
+	  if (g_atomic_pointer_compare_and_exchange (&collector->priv->head,
+						     NULL, list))
+	    return;
+
+	  continue;
+	}
+
+      for (node = head; node->next; node = node->next)
+	;
+
+      g_atomic_pointer_set (&node->next, list);
+      return;
+    }
+}
+
+static GSList *
+get_children (GContainerable *containerable)
+{
+  GCollector     *collector;
+  GCollectorNode *node;
+  GSList         *children;
+
+  collector = (GCollector *) containerable;
+  children = NULL;
+
+  g_rec_mutex_lock (&collector->priv->consumer);
+
+  /* Walking from the newest child allows to build the list by prepending */
+  for (node = g_atomic_pointer_get (&collector->priv->head); node; node = node->next)
+    children = g_slist_prepend (children, node->childable);
+
+  g_rec_mutex_unlock (&collector->priv->consumer);
+
+  return children;
+}
+
+static gboolean
+add (GContainerable *containerable,
+     GChildable     *childable)
+{
+  GCollectorNode *node;
+
+  node = g_slice_new (GCollectorNode);
+  node->childable = childable;
+  push ((GCollector *) containerable, node, node);
+
+  return TRUE;
+}
+
+static gboolean
+remove (GContainerable *containerable,
+	GChildable     *childable)
+{
+  GCollector     *collector;
+  GCollectorNode *list, *node, *prev, *found;
+
+  collector = (GCollector *) containerable;
+  found = NULL;
+
+  g_rec_mutex_lock (&collector->priv->consumer);
+
+  list = detach (collector);
+
+  for (node = list, prev = NULL; node; prev = node, node = node->next)
+    if (node->childable == childable)
+      {
+	found = node;
+
+	if (prev)
+	  prev->next = node->next;
+	else
+	  list = node->next;
+
+	break;
+      }
+
+  restore (collector, list);
+
+  g_rec_mutex_unlock (&collector->priv->consumer);
+
+  if (found == NULL)
+    return FALSE;
+
+  g_slice_free (GCollectorNode, found);
+  return TRUE;
+}
+
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GCollector     *collector;
+  GCollectorNode *head, *node;
+  GChildable    **children;
+  guint           n, n_children;
+
+  collector = (GCollector *) containerable;
+
+  g_rec_mutex_lock (&collector->priv->consumer);
+
+  /* func() is not called with the consumer lock held, so a slow callback
+   * does not stall the other consumers: the children are copied and
+   * referenced, so they survive a concurrent removal */
+  head = g_atomic_pointer_get (&collector->priv->head);
+  n_children = 0;
+  for (node = head; node; node = node->next)
+    ++ n_children;
+
+  children = g_new (GChildable *, n_children);
+  for (node = head, n = n_children; node; node = node->next)
+    children[-- n] = g_object_ref (node->childable);
+
+  g_rec_mutex_unlock (&collector->priv->consumer);
+
+  for (n = 0; n < n_children; ++ n)
+    func (children[n], user_data);
+
+  for (n = 0; n < n_children; ++ n)
+    g_object_unref (children[n]);
+
+  g_free (children);
+}
+
+static gboolean
+add_many (GContainerable *containerable,
+	  guint           n_children,
+	  GChildable    **children)
+{
+  GCollectorNode *first, *last, *node;
+  guint           n;
+
+  first = last = NULL;
+
+  /* The whole chain is pushed at once, the last child on top */
+  for (n = 0; n < n_children; ++ n)
+    {
+      node = g_slice_new (GCollectorNode);
+      node->childable = children[n];
+      node->next = first;
+      first = node;
+
+      if (last == NULL)
+	last = node;
+    }
+
+  push ((GCollector *) containerable, first, last);
+  return TRUE;
+}
+
+static gboolean
+remove_many (GContainerable *containerable,
+	     guint           n_children,
+	     GChildable    **children)
+{
+  GCollector     *collector;
+  GCollectorNode *list, *node, *next, *kept, *last, *removed;
+  GHashTable     *set;
+  guint           n, n_found;
+
+  collector = (GCollector *) containerable;
+  set = g_hash_table_new (NULL, NULL);
+
+  for (n = 0; n < n_children; ++ n)
+    g_hash_table_insert (set, children[n], children[n]);
+
+  g_rec_mutex_lock (&collector->priv->consumer);
+
+  list = detach (collector);
+
+  /* Check in advance, so nothing is touched if some child is missing */
+  n_found = 0;
+  for (node = list; node; node = node->next)
+    if (g_hash_table_lookup (set, node->childable))
+      ++ n_found;
+
+  if (n_found < n_children)
+    {
+      restore (collector, list);
+      g_rec_mutex_unlock (&collector->priv->consumer);
+      g_hash_table_destroy (set);
+      return FALSE;
+    }
+
+  kept = last = removed = NULL;
+
+  for (node = list; node; node = next)
+    {
+      next = node->next;
+
+      if (g_hash_table_lookup (set, node->childable))
+	{
+	  node->next = removed;
+	  removed = node;
+	}
+      else
+	{
+	  node->next = NULL;
+
+	  if (last)
+	    last->next = node;
+	  else
+	    kept = node;
+
+	  last = node;
+	}
+    }
+
+  restore (collector, kept);
+
+  g_rec_mutex_unlock (&collector->priv->consumer);
+
+  for (node = removed; node; node = next)
+    {
+      next = node->next;
+      g_slice_free (GCollectorNode, node);
+    }
+
+  g_hash_table_destroy (set);
+  return TRUE;
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+
+/**
+ * g_collector_new:
+ *
+ * Creates a new collector.
+ *
+ * Return value: a #GCollector instance
+ **/
+GObject *
+g_collector_new (void)
+{
+  return g_object_new (G_TYPE_COLLECTOR, NULL);
+}
+
+/**
+ * g_collector_take_all:
+ * @collector: a #GCollector
+ *
+ * Removes from @collector all the children collected so far, in a single
+ * #GContainerable::remove-many emission, and gives them back in the
+ * order they were added. Children added while this function is running
+ * are left in @collector.
+ *
+ * The returned array holds a reference to each child and must be
+ * released with g_ptr_array_unref().
+ *
+ * Returns: a new array of the removed children, or %NULL on errors
+ **/
+GPtrArray *
+g_collector_take_all (GCollector *collector)
+{
+  GContainerable *containerable;
+  GCollectorNode *node;
+  GPtrArray      *children;
+  gpointer        child;
+  guint           n, n_children;
+
+  g_return_val_if_fail (G_IS_COLLECTOR (collector), NULL);
+
+  containerable = (GContainerable *) collector;
+
+  g_rec_mutex_lock (&collector->priv->consumer);
+
+  /* A child is collected before its parent is set: the ones whose
+   * add is still in progress are skipped. The stack is walked from the
+   * newest child, so the array is reversed afterward */
+  children = g_ptr_array_new_with_free_func (g_object_unref);
+
+  for (node = g_atomic_pointer_get (&collector->priv->head); node; node = node->next)
+    if (g_childable_get_parent (node->childable) == containerable)
+      g_ptr_array_add (children, g_object_ref (node->childable));
+
+  n_children = children->len;
+
+  for (n = 0; n < n_children / 2; ++ n)
+    {
+      child = g_ptr_array_index (children, n);
+      g_ptr_array_index (children, n) = g_ptr_array_index (children, n_children - n - 1);
+      g_ptr_array_index (children, n_children - n - 1) = child;
+    }
+
+  if (n_children > 0)
+    {
+      g_containerable_remove_many (containerable, n_children,
+				   (GChildable **) children->pdata,
+				   G_CONTAINERABLE_EMIT_BATCH);
+
+      /* The batch is removed entirely or not at all */
+      if (g_childable_get_parent (g_ptr_array_index (children, 0)) == containerable)
+	g_ptr_array_set_size (children, 0);
+    }
+
+  g_rec_mutex_unlock (&collector->priv->consumer);
+
+  return children;
+}
@@ -24,7 +24,28 @@
  *
  * An implementation of #GContainerable to manage a generic list of #GObject
  * that implements #GChildable. The children are internally managed trought
- * a #GSList.
+ * a #GSequence, a balanced tree indexed by position, so appending a child,
+ * removing it and looking up the child at a given position are O(log n)
+ * and never walk the whole list. The tree node of every child is also
+ * indexed by child, so removing a child does not need to search for it
+ * and g_containerable_contains() is O(1). The array returned by
+ * g_containerable_get_children_snapshot() is cached and shared until
+ * the children change: while it is cached, g_containerable_get_nth()
+ * indexes it in O(1).
+ *
+ * A container created with the #GContainer:thread-safe property set
+ * protects its children with a reader/writer lock: any number of threads
+ * can iterate on the children at the same time, while adding or removing
+ * a child waits for the readers to finish. The parent of a #GChild is
+ * always read and written atomically.
+ *
+ * The lock protects the storage of the children, not the whole adding or
+ * removing operation: a given child must be added and removed by one
+ * thread at a time. Two threads adding the same parentless child to two
+ * containers can both succeed, because the parent is checked before and
+ * set after the child is stored. For the same reason, a reader can see
+ * for a moment a child that is stored but whose parent is not set yet,
+ * or a removed child that still has its parent set.
  **/
 
 /**
@@ -36,16 +57,42 @@
 
 #include "gcontainer.h"
 #include "gcontainerprivate.h"
+#include "gchildprivate.h"
+#include "ginstancepool.h"
+#include "gcontainerintl.h"
+#include "gifacecache.h"
 
 
 enum
 {
   PROP_0,
-  PROP_CHILD
+  PROP_CHILD,
+  PROP_THREAD_SAFE
 };
 
 
+/* The lock is a no-op on containers not created as thread safe */
+#define LOCK(container,mode)	G_STMT_START { \
+  if ((container)->priv->thread_safe) \
+    g_rw_lock_##mode##_lock (&(container)->priv->lock); \
+} G_STMT_END
+#define UNLOCK(container,mode)	G_STMT_START { \
+  if ((container)->priv->thread_safe) \
+    g_rw_lock_##mode##_unlock (&(container)->priv->lock); \
+} G_STMT_END
+#define READER_LOCK(container)		LOCK (container, reader)
+#define READER_UNLOCK(container)	UNLOCK (container, reader)
+#define WRITER_LOCK(container)		LOCK (container, writer)
+#define WRITER_UNLOCK(container)	UNLOCK (container, writer)
+
+
 static void	containerable_init	(GContainerableIface *iface);
+static void	dispose			(GObject	*object);
+static void	finalize		(GObject	*object);
+static void     get_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         GValue		*value,
+                                         GParamSpec	*pspec);
 static void     set_property		(GObject	*object,
                                          guint		 prop_id,
                                          const GValue	*value,
@@ -55,6 +102,37 @@ static gboolean add			(GContainerable	*containerable,
                                          GChildable	*childable);
 static gboolean remove			(GContainerable	*containerable,
                                          GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+                                         GFunc		 func,
+                                         gpointer	 user_data);
+static gboolean add_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static gboolean remove_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static guint *	get_flags		(GContainerable	*containerable);
+static GPtrArray *
+		get_children_snapshot	(GContainerable	*containerable);
+static gboolean move_child		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         GContainerable	*old_parent);
+static guint	n_children		(GContainerable	*containerable);
+static gboolean contains		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static GChildable *
+		get_nth			(GContainerable	*containerable,
+                                         guint		 nth);
+static gboolean add_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gboolean remove_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gint	get_position		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static GPtrArray *
+		steal_snapshot		(GContainer	*container);
 
 
 G_DEFINE_TYPE_EXTENDED (GContainer, g_container, G_TYPE_CHILD, 0, 
@@ -62,12 +140,27 @@ G_DEFINE_TYPE_EXTENDED (GContainer, g_container, G_TYPE_CHILD, 0,
                                                containerable_init));
 
 
+static GInstancePool pool = G_INSTANCE_POOL_INIT;
+
+
 static void
 containerable_init (GContainerableIface *iface)
 {
   iface->get_children = get_children;
   iface->add = add;
   iface->remove = remove;
+  iface->foreach = foreach;
+  iface->add_many = add_many;
+  iface->remove_many = remove_many;
+  iface->get_flags = get_flags;
+  iface->get_children_snapshot = get_children_snapshot;
+  iface->move_child = move_child;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
+  iface->add_indexed = add_indexed;
+  iface->remove_indexed = remove_indexed;
+  iface->get_position = get_position;
 }
 
 static void
@@ -79,10 +172,29 @@ g_container_class_init (GContainerClass *klass)
 
   g_type_class_add_private (klass, sizeof (GContainerPrivate));
 
+  gobject_class->get_property = get_property;
   gobject_class->set_property = set_property;
-  gobject_class->dispose = g_containerable_dispose;
+  gobject_class->dispose = dispose;
+  gobject_class->finalize = finalize;
 
   g_object_class_override_property (gobject_class, PROP_CHILD, "child");
+
+  /**
+   * GContainer:thread-safe:
+   *
+   * Whether the children of the container can be accessed by more
+   * threads at the same time. Can be set only at construction time.
+   *
+   * Different threads can add and remove different children, but
+   * every single child must have one writer at a time: see the
+   * #GContainer description for details.
+   **/
+  g_object_class_install_property (gobject_class, PROP_THREAD_SAFE,
+				   g_param_spec_boolean ("thread-safe",
+							 P_("Thread safe"),
+							 P_("Whether the children can be accessed concurrently"),
+							 FALSE,
+							 G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 }
 
 static void
@@ -90,7 +202,58 @@ g_container_init (GContainer *container)
 {
   container->priv = G_TYPE_INSTANCE_GET_PRIVATE (container, G_TYPE_CONTAINER, 
 						 GContainerPrivate);
-  container->priv->children = NULL;
+  container->priv->children = g_sequence_new (NULL);
+  container->priv->iters = g_hash_table_new (NULL, NULL);
+  container->priv->thread_safe = FALSE;
+  g_rw_lock_init (&container->priv->lock);
+  container->priv->snapshot = NULL;
+  container->priv->walks = NULL;
+}
+
+static void
+dispose (GObject *object)
+{
+  g_containerable_dispose (object);
+
+  /* Subclasses are not pooled: they could have their own state.
+   * Thread safe containers are not pooled too, because
+   * g_container_new() returns a container in the default mode */
+  if (G_OBJECT_TYPE (object) == G_TYPE_CONTAINER &&
+      ! ((GContainer *) object)->priv->thread_safe)
+    _g_instance_pool_release (&pool, object);
+}
+
+static void
+finalize (GObject *object)
+{
+  GContainer *container = (GContainer *) object;
+
+  g_sequence_free (container->priv->children);
+  g_hash_table_destroy (container->priv->iters);
+  g_rw_lock_clear (&container->priv->lock);
+
+  if (container->priv->snapshot != NULL)
+    g_ptr_array_unref (container->priv->snapshot);
+
+  G_OBJECT_CLASS (g_container_parent_class)->finalize (object);
+}
+
+static void
+get_property (GObject    *object,
+	      guint       prop_id,
+	      GValue     *value,
+	      GParamSpec *pspec)
+{
+  GContainer *container = (GContainer *) object;
+
+  switch (prop_id)
+    {
+    case PROP_THREAD_SAFE:
+      g_value_set_boolean (value, container->priv->thread_safe);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
 }
 
 static void
@@ -106,6 +269,9 @@ set_property (GObject      *object,
     case PROP_CHILD:
       g_containerable_add (containerable, g_value_get_object (value));
       break;
+    case PROP_THREAD_SAFE:
+      ((GContainer *) object)->priv->thread_safe = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -115,40 +281,417 @@ set_property (GObject      *object,
 static GSList *
 get_children (GContainerable *containerable)
 {
-  GContainer *container = (GContainer *) containerable;
+  GContainer    *container;
+  GSList        *children;
+  GSequenceIter *iter, *begin;
+
+  container = (GContainer *) containerable;
+  children = NULL;
+
+  READER_LOCK (container);
+
+  iter = g_sequence_get_end_iter (container->priv->children);
+  begin = g_sequence_get_begin_iter (container->priv->children);
 
-  return g_slist_copy (container->priv->children);
+  /* Walking backward allows to build the list by prepending */
+  while (iter != begin)
+    {
+      iter = g_sequence_iter_prev (iter);
+      children = g_slist_prepend (children, g_sequence_get (iter));
+    }
+
+  READER_UNLOCK (container);
+
+  return children;
 }
 
 static gboolean
 add (GContainerable *containerable,
      GChildable     *childable)
 {
-  GContainer *container = (GContainer *) containerable;
-
-  container->priv->children = g_slist_append (container->priv->children,
-					      childable);
-  return TRUE;
+  return add_indexed (containerable, childable, NULL);
 }
 
 static gboolean
 remove (GContainerable *containerable,
 	GChildable     *childable)
+{
+  return remove_indexed (containerable, childable, NULL);
+}
+
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GContainer    *container;
+  GSequenceWalk  walk;
+  GSequenceIter *iter;
+
+  container = (GContainer *) containerable;
+
+  /* func() cannot be called with the lock held: it could modify the
+   * container, and a writer lock taken by the thread that holds the
+   * reader lock deadlocks. The snapshot keeps a reference to the
+   * children instead, so they survive a concurrent removal */
+  if (container->priv->thread_safe)
+    {
+      GPtrArray *snapshot;
+      guint      n;
+
+      snapshot = get_children_snapshot (containerable);
+
+      for (n = 0; n < snapshot->len; ++ n)
+	func (g_ptr_array_index (snapshot, n), user_data);
+
+      g_ptr_array_unref (snapshot);
+      return;
+    }
+
+  /* func() can remove any child: the walk is registered, so the
+   * removals move it past the nodes they free */
+  _g_sequence_walk_begin (&walk, &container->priv->walks,
+			  container->priv->children);
+
+  while ((iter = _g_sequence_walk_next (&walk)) != NULL)
+    func (g_sequence_get (iter), user_data);
+
+  _g_sequence_walk_end (&walk, &container->priv->walks);
+}
+
+static gboolean
+add_many (GContainerable *containerable,
+	  guint           n_children,
+	  GChildable    **children)
+{
+  GContainer    *container;
+  GSequenceIter *iter;
+  GPtrArray     *stale;
+  guint          n;
+
+  container = (GContainer *) containerable;
+
+  WRITER_LOCK (container);
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      iter = g_sequence_append (container->priv->children, children[n]);
+      g_hash_table_insert (container->priv->iters, children[n], iter);
+    }
+
+  stale = steal_snapshot (container);
+  WRITER_UNLOCK (container);
+
+  if (stale != NULL)
+    g_ptr_array_unref (stale);
+
+  return TRUE;
+}
+
+static gboolean
+remove_many (GContainerable *containerable,
+	     guint           n_children,
+	     GChildable    **children)
+{
+  GContainer    *container;
+  GSequenceIter *iter;
+  GPtrArray     *stale;
+  guint          n;
+
+  container = (GContainer *) containerable;
+
+  WRITER_LOCK (container);
+
+  /* Check in advance, so nothing is touched if some child is missing */
+  for (n = 0; n < n_children; ++ n)
+    if (!g_hash_table_lookup (container->priv->iters, children[n]))
+      {
+	WRITER_UNLOCK (container);
+	return FALSE;
+      }
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      iter = g_hash_table_lookup (container->priv->iters, children[n]);
+
+      /* A child listed twice is already gone the second time */
+      if (iter)
+	{
+	  g_hash_table_remove (container->priv->iters, children[n]);
+	  _g_sequence_walk_skip (container->priv->walks, iter);
+	  g_sequence_remove (iter);
+	}
+    }
+
+  stale = steal_snapshot (container);
+  WRITER_UNLOCK (container);
+
+  if (stale != NULL)
+    g_ptr_array_unref (stale);
+
+  return TRUE;
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+static GPtrArray *
+get_children_snapshot (GContainerable *containerable)
+{
+  GContainer    *container;
+  GPtrArray     *snapshot;
+  GSequenceIter *iter;
+
+  container = (GContainer *) containerable;
+
+  READER_LOCK (container);
+
+  snapshot = g_atomic_pointer_get (&container->priv->snapshot);
+
+  if (snapshot == NULL)
+    {
+      /* More readers can build the array at the same time:
+       * only the first one is cached, the others are dropped */
+      snapshot = g_ptr_array_new_full (g_sequence_get_length (container->priv->children),
+				       g_object_unref);
+
+      for (iter = g_sequence_get_begin_iter (container->priv->children);
+	   !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter))
+	g_ptr_array_add (snapshot, g_object_ref (g_sequence_get (iter)));
+
+      if (!g_atomic_pointer_compare_and_exchange (&container->priv->snapshot,
+						  NULL, snapshot))
+	{
+	  g_ptr_array_unref (snapshot);
+	  snapshot = g_atomic_pointer_get (&container->priv->snapshot);
+	}
+    }
+
+  /* The cached array cannot be released while the reader lock is held */
+  g_ptr_array_ref (snapshot);
+
+  READER_UNLOCK (container);
+
+  return snapshot;
+}
+
+static gboolean
+move_child (GContainerable *containerable,
+	    GChildable     *childable,
+	    GContainerable *old_parent)
+{
+  GContainer    *container, *old_container;
+  GContainer    *first, *second;
+  GSequenceIter *iter;
+  GPtrArray     *stale, *old_stale;
+
+  container = (GContainer *) containerable;
+  old_container = (GContainer *) old_parent;
+  stale = old_stale = NULL;
+
+  /* Both the containers are locked, always in the same order,
+   * so two moves in opposite directions cannot deadlock */
+  if (container < old_container)
+    first = container, second = old_container;
+  else
+    first = old_container, second = container;
+
+  WRITER_LOCK (first);
+  WRITER_LOCK (second);
+
+  iter = g_hash_table_lookup (old_container->priv->iters, childable);
+
+  if (iter)
+    {
+      /* The tree node itself is moved, so nothing is allocated */
+      g_hash_table_remove (old_container->priv->iters, childable);
+      _g_sequence_walk_skip (old_container->priv->walks, iter);
+      g_sequence_move (iter, g_sequence_get_end_iter (container->priv->children));
+      g_hash_table_insert (container->priv->iters, childable, iter);
+
+      /* The reference owned by the old parent passes to the new one */
+      G_CHILDABLE_PEEK_IFACE (childable)->set_parent (childable, containerable);
+
+      old_stale = steal_snapshot (old_container);
+      stale = steal_snapshot (container);
+    }
+
+  WRITER_UNLOCK (second);
+  WRITER_UNLOCK (first);
+
+  if (old_stale != NULL)
+    g_ptr_array_unref (old_stale);
+  if (stale != NULL)
+    g_ptr_array_unref (stale);
+
+  return iter != NULL;
+}
+
+static guint
+n_children (GContainerable *containerable)
 {
   GContainer *container;
-  GSList     *node;
+  guint       length;
+
+  container = (GContainer *) containerable;
+
+  READER_LOCK (container);
+  length = g_sequence_get_length (container->priv->children);
+  READER_UNLOCK (container);
+
+  return length;
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  GContainer *container;
+  gboolean    found;
+
+  container = (GContainer *) containerable;
+
+  READER_LOCK (container);
+  found = g_hash_table_lookup (container->priv->iters, childable) != NULL;
+  READER_UNLOCK (container);
+
+  return found;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  GContainer *container;
+  GPtrArray  *snapshot;
+  GChildable *childable;
+
+  container = (GContainer *) containerable;
+
+  READER_LOCK (container);
+
+  /* A cached snapshot is indexed directly, but it is not built here:
+   * that would take a reference on every child just to read one of
+   * them. The tree is descended instead */
+  snapshot = g_atomic_pointer_get (&container->priv->snapshot);
+
+  if (snapshot != NULL)
+    childable = nth < snapshot->len ? g_ptr_array_index (snapshot, nth) : NULL;
+  else if (nth < (guint) g_sequence_get_length (container->priv->children))
+    childable = g_sequence_get (g_sequence_get_iter_at_pos (container->priv->children, nth));
+  else
+    childable = NULL;
+
+  READER_UNLOCK (container);
+
+  return childable;
+}
+
+/* The position is computed under the writer lock, so it is coherent
+ * with the change even if other threads modify the container. A %NULL
+ * @position is accepted for the plain add() and remove() methods. */
+
+static gboolean
+add_indexed (GContainerable *containerable,
+	     GChildable     *childable,
+	     guint          *position)
+{
+  GContainer    *container;
+  GSequenceIter *iter;
+  GPtrArray     *stale;
 
   container = (GContainer *) containerable;
-  node = g_slist_find (container->priv->children, childable);
 
-  if (!node)
-    return FALSE;
+  WRITER_LOCK (container);
+
+  iter = g_sequence_append (container->priv->children, childable);
+  g_hash_table_insert (container->priv->iters, childable, iter);
+
+  if (position != NULL)
+    *position = g_sequence_iter_get_position (iter);
+
+  stale = steal_snapshot (container);
+  WRITER_UNLOCK (container);
+
+  if (stale != NULL)
+    g_ptr_array_unref (stale);
 
-  container->priv->children = g_slist_delete_link (container->priv->children,
-						   node);
   return TRUE;
 }
 
+static gboolean
+remove_indexed (GContainerable *containerable,
+		GChildable     *childable,
+		guint          *position)
+{
+  GContainer    *container;
+  GSequenceIter *iter;
+  GPtrArray     *stale;
+
+  container = (GContainer *) containerable;
+  stale = NULL;
+
+  WRITER_LOCK (container);
+
+  iter = g_hash_table_lookup (container->priv->iters, childable);
+
+  if (iter)
+    {
+      /* The position is read walking up the tree, in O(log n) */
+      if (position != NULL)
+	*position = g_sequence_iter_get_position (iter);
+
+      g_hash_table_remove (container->priv->iters, childable);
+      _g_sequence_walk_skip (container->priv->walks, iter);
+      g_sequence_remove (iter);
+      stale = steal_snapshot (container);
+    }
+
+  WRITER_UNLOCK (container);
+
+  if (stale != NULL)
+    g_ptr_array_unref (stale);
+
+  return iter != NULL;
+}
+
+static gint
+get_position (GContainerable *containerable,
+	      GChildable     *childable)
+{
+  GContainer    *container;
+  GSequenceIter *iter;
+  gint           position;
+
+  container = (GContainer *) containerable;
+
+  READER_LOCK (container);
+  iter = g_hash_table_lookup (container->priv->iters, childable);
+  position = iter != NULL ? g_sequence_iter_get_position (iter) : -1;
+  READER_UNLOCK (container);
+
+  return position;
+}
+
+static GPtrArray *
+steal_snapshot (GContainer *container)
+{
+  GPtrArray *snapshot;
+
+  /* Called with the writer lock held, so no reader can be caching
+   * a new array meanwhile. The returned array must be released after
+   * the lock, because it can hold the last reference to a child */
+  snapshot = container->priv->snapshot;
+  g_atomic_pointer_set (&container->priv->snapshot, NULL);
+
+  return snapshot;
+}
+
 
 /**
  * g_container_new:
@@ -160,5 +703,45 @@ remove (GContainerable *containerable,
 GObject *
 g_container_new (void)
 {
-  return g_object_new (G_TYPE_CONTAINER, NULL);
+  GObject *object;
+
+  object = _g_instance_pool_acquire (&pool);
+
+  if (object == NULL)
+    return g_object_new (G_TYPE_CONTAINER, NULL);
+
+  /* The children are released by dispose and the attached data, such
+   * as the state of a children notification left frozen, by the pool */
+  ((GChild *) object)->priv->flags = 0;
+  return object;
+}
+
+/**
+ * g_container_set_pool_limit:
+ * @limit: maximum number of instances to retain, or 0 to disable the pool
+ *
+ * Enables the recycling of #GContainer instances, in the same way
+ * g_child_set_pool_limit() does for #GChild. A recycled container is
+ * empty and keeps its internal storage, so it does not need to be
+ * allocated again.
+ **/
+void
+g_container_set_pool_limit (guint limit)
+{
+  _g_instance_pool_set_limit (&pool, limit);
+}
+
+/**
+ * g_container_get_pool_stats:
+ * @stats: where to store the statistics
+ *
+ * Gets the statistics of the #GContainer pool.
+ * See g_child_set_pool_limit() for further details.
+ **/
+void
+g_container_get_pool_stats (GInstancePoolStats *stats)
+{
+  g_return_if_fail (stats != NULL);
+
+  _g_instance_pool_get_stats (&pool, stats);
 }
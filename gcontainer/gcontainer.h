@@ -26,6 +26,11 @@
 
 #include <gcontainer/gchild.h>
 #include <gcontainer/gbin.h>
+#include <gcontainer/gcollector.h>
+#include <gcontainer/gslot.h>
+#include <gcontainer/gkeyedcontainer.h>
+#include <gcontainer/gsortedcontainer.h>
+#include <gcontainer/gchunkedcontainer.h>
 
 
 G_BEGIN_DECLS
@@ -59,6 +64,10 @@ struct _GContainerClass
 
 GType			g_container_get_type	(void) G_GNUC_CONST;
 GObject *		g_container_new		(void);
+void			g_container_set_pool_limit
+							(guint		 limit);
+void			g_container_get_pool_stats
+							(GInstancePoolStats *stats);
 
 
 G_END_DECLS
@@ -37,6 +37,28 @@
  * Dummy type of the #GContainerableIface interface.
  **/
 
+/**
+ * GContainerableEmission:
+ * @G_CONTAINERABLE_EMIT_EACH:	emits a #GContainerable::add or
+ *				#GContainerable::remove signal per child.
+ * @G_CONTAINERABLE_EMIT_BATCH:	emits a single #GContainerable::add-many or
+ *				#GContainerable::remove-many signal for the
+ *				whole batch.
+ *
+ * How g_containerable_add_many() and g_containerable_remove_many() notify
+ * the listeners of the container.
+ **/
+
+/**
+ * GContainerableProgressFunc:
+ * @n_disposed:	number of objects released so far
+ * @n_pending:	number of objects still to be released
+ * @user_data:	data passed to g_containerable_dispose_async()
+ *
+ * Reports the progress of g_containerable_dispose_async().
+ * The job is completed when @n_pending is 0.
+ **/
+
 /**
  * GContainerableIface:
  * @base_iface:		the base interface.
@@ -44,26 +66,154 @@
  * @remove:		signal handler for #GContainerable::remove signals.
  * @get_children:	returns a newly allocated #GSList containing the
  *                      children list of the container.
+ * @foreach:		calls a function on every child without allocating
+ *			anything. The function is allowed to add or remove
+ *			any child; removed children not yet visited are
+ *			skipped.
+ * @add_many:		signal handler for #GContainerable::add-many signals.
+ *			Either all the children are added or none of them.
+ * @remove_many:	signal handler for #GContainerable::remove-many
+ *			signals. Either all the children are removed or
+ *			none of them.
+ * @get_flags:		returns the location of a #guint reserved to the
+ *			interface for its internal state.
+ * @get_children_snapshot: returns a new reference to an immutable array
+ *			of the children, that owns a reference to each of
+ *			them.
+ * @move_child:		moves a child from @old_parent, that has the same
+ *			@move_child method, to the container in a single
+ *			step, also changing its parent. Returns %FALSE if
+ *			the child is no more inside @old_parent.
+ * @n_children:		returns the number of children.
+ * @contains:		checks if a child is inside the container.
+ * @get_nth:		returns the child at a given position, or %NULL if
+ *			the position is out of range.
+ * @add_indexed:	same as @add, also storing in @position the position
+ *			where the child has been added.
+ * @remove_indexed:	same as @remove, also storing in @position the
+ *			position the child had before the removal.
+ * @get_position:	returns the position of a child, or -1 if it is not
+ *			inside the container.
  *
  * The virtual methods @add, @remove and @get_children must be defined
- * by all the types which implement this interface.
+ * by all the types which implement this interface. @foreach is optional:
+ * if not implemented, a default method that walks a copy of the list
+ * returned by @get_children is used. Also @add_many and @remove_many are
+ * optional: the default methods call @add and @remove on every child.
+ * @get_flags is optional too: the default method keeps the flags in the
+ * object data. Objects implementing also #GChildable must return the same
+ * location from #GChildableIface.get_flags. The default
+ * @get_children_snapshot builds a new array on every call: containers
+ * should override it to share the same array until their children change.
+ * @move_child is optional: without it, g_containerable_move() falls back
+ * to g_childable_reparent(). @n_children, @contains and @get_nth are
+ * optional: the default methods walk the children with @foreach, so
+ * containers should override them with something better than O(n).
+ * @add_indexed, @remove_indexed and @get_position are optional and have
+ * no default: they are used only when somebody listens to
+ * #GContainerable::children-changed, to report the position of the
+ * children added or removed, the first two for single children and
+ * @get_position for batches. Without them the positions are looked up
+ * by walking the children with @foreach.
  **/
 
 
 #include "gcontainerable.h"
+#include "gcontainerableprivate.h"
 #include "gobjectmissings.h"
 #include "gcontainerintl.h"
+#include "gflagsprivate.h"
+#include "gifacecache.h"
+#include <gobject/gvaluecollector.h>
+#include <string.h>
 
-#define G_CONTAINERABLE_IS_DISPOSING(obj)   ((gboolean) GPOINTER_TO_INT (g_object_get_qdata ((GObject *) (obj), quark_disposing)))
-#define G_CONTAINERABLE_SET_DISPOSING(obj)  g_object_set_qdata ((GObject *) (obj), quark_disposing, GINT_TO_POINTER ((gint) TRUE))
+#define G_CONTAINERABLE_FLAGS(iface,obj)	(*(iface)->get_flags ((GContainerable *) (obj)))
 
 enum
 {
   ADD,
   REMOVE,
+  ADD_MANY,
+  REMOVE_MANY,
+  CHILDREN_CHANGED,
   LAST_SIGNAL
 };
 
+typedef struct _ChildrenNotify ChildrenNotify;
+
+struct _ChildrenNotify
+{
+  guint		 freeze_count;
+  gboolean	 pending;
+  guint		 position;
+  guint		 removed;
+  guint		 added;
+};
+
+typedef struct _DeepItem DeepItem;
+
+struct _DeepItem
+{
+  GObject	*object;
+  gboolean	 expanded;
+};
+
+typedef struct _DisposeJob DisposeJob;
+
+struct _DisposeJob
+{
+  GQueue			 worklist;
+  guint				 chunk_size;
+  guint				 n_disposed;
+  GContainerableProgressFunc	 progress;
+  gpointer			 user_data;
+  GDestroyNotify		 notify;
+};
+
+typedef struct _FindData FindData;
+
+struct _FindData
+{
+  guint		 n_children;
+  GChildable   **children;
+  GHashTable	*set;
+  guint		 index;
+  guint		 n_found;
+  guint		 first;
+  guint		 last;
+};
+
+typedef struct _InsertFrame InsertFrame;
+
+struct _InsertFrame
+{
+  GContainerable		*containerable;
+  GChildable			*childable;
+  GContainerableInsertFunc	 insert;
+  gint				 position;
+  InsertFrame			*outer;
+};
+
+typedef struct _NthData NthData;
+
+struct _NthData
+{
+  guint		 index;
+  guint		 nth;
+  GChildable	*childable;
+};
+
+typedef struct _PropagateData PropagateData;
+
+struct _PropagateData
+{
+  guint		 signal_id;
+  GQuark	 detail;
+  GValue	*instance_and_params;
+  GValue	*return_value;
+  gboolean	 emitted;
+};
+
 
 static void	iface_base	(GContainerableIface *iface);
 static void	iface_init	(GContainerableIface *iface);
@@ -73,15 +223,117 @@ static void    	real_add	(GContainerable	*containerable,
 static void    	real_remove	(GContainerable	*containerable,
 				 GChildable	*childable,
 				 gpointer	 user_data);
+static void	real_add_many	(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children,
+				 gpointer	 user_data);
+static void	real_remove_many(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children,
+				 gpointer	 user_data);
+static gboolean	add_child	(GContainerable	*containerable,
+				 GChildable	*childable);
+static gboolean	remove_child	(GContainerable	*containerable,
+				 GChildable	*childable);
+static gboolean	add_children	(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children);
+static gboolean	remove_children	(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children);
+static gboolean	find_range	(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children,
+				 guint		*position,
+				 guint		*span);
+static void	children_changed(GContainerable	*containerable,
+				 guint		 position,
+				 guint		 removed,
+				 guint		 added);
+static InsertFrame *
+		take_insert	(GContainerable	*containerable,
+				 GChildable	*childable);
+static void	emit_add	(GContainerable	*containerable,
+				 GChildable	*childable);
+static void	emit_remove	(GContainerable	*containerable,
+				 GChildable	*childable);
 static GSList *	get_children	(GContainerable	*containerable);
 static gboolean	add		(GContainerable	*containerable,
 				 GChildable	*childable);
 static gboolean	remove		(GContainerable	*containerable,
 				 GChildable	*childable);
-
-
-static GQuark 	quark_disposing = 0;
+static void	foreach		(GContainerable	*containerable,
+				 GFunc		 func,
+				 gpointer	 user_data);
+static gboolean	add_many	(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children);
+static gboolean	remove_many	(GContainerable	*containerable,
+				 guint		 n_children,
+				 GChildable    **children);
+static guint *	get_flags	(GContainerable	*containerable);
+static GPtrArray *
+		get_children_snapshot
+				(GContainerable	*containerable);
+static guint	n_children	(GContainerable	*containerable);
+static gboolean	contains	(GContainerable	*containerable,
+				 GChildable	*childable);
+static GChildable *
+		get_nth		(GContainerable	*containerable,
+				 guint		 nth);
+static void	snapshot_child	(GObject	*child,
+				 GPtrArray	*snapshot);
+static gboolean	propagate	(GContainerable	*containerable,
+				 guint		 signal_id,
+				 GQuark		 detail,
+				 GValue		*instance_and_params,
+				 GValue		*return_value);
+static gboolean	propagate_deep	(GContainerable	*containerable,
+				 GTraverseType	 order,
+				 GType		 itype,
+				 guint		 signal_id,
+				 GQuark		 detail,
+				 GValue		*instance_and_params,
+				 GValue		*return_value);
+static void	push_children	(GArray		*stack,
+				 GHashTable	*visited,
+				 GPtrArray	*scratch,
+				 GContainerable	*containerable);
+static void	propagate_valist(GContainerable	*containerable,
+				 gboolean	 deep,
+				 GTraverseType	 order,
+				 guint		 signal_id,
+				 GQuark		 detail,
+				 va_list	 var_args);
+static void	propagate_values(GContainerable	*containerable,
+				 gboolean	 deep,
+				 GTraverseType	 order,
+				 guint		 signal_id,
+				 GQuark		 detail,
+				 const GValue	*params,
+				 GValue		*return_value);
+static void	find_child	(GChildable	*childable,
+				 FindData	*data);
+static void	count_child	(GChildable	*childable,
+				 guint		*count);
+static void	nth_child	(GChildable	*childable,
+				 NthData	*data);
+static void	propagate_child	(GChildable	*childable,
+				 PropagateData	*data);
+static void	collect_child	(GChildable	*childable,
+				 GPtrArray	*children);
+static void	dispose_child	(GChildable	*childable,
+				 GContainerable	*containerable);
+static gboolean	dispose_chunk	(DisposeJob	*job);
+static void	dispose_job_free(DisposeJob	*job);
+
+
+static GQuark 	quark_flags = 0;
+static GQuark 	quark_children_notify = 0;
+static guint	parent_set_signal = 0;
 static guint	signals[LAST_SIGNAL] = { 0 };
+static GPrivate	dispose_worklist = G_PRIVATE_INIT (NULL);
+static GPrivate	insert_frames = G_PRIVATE_INIT (NULL);
 
 
 GType
@@ -115,13 +367,14 @@ iface_base (GContainerableIface *iface)
   static gboolean initialized = FALSE;
   GParamSpec     *param;
   GClosure       *closure;
-  GType           param_types[1];
+  GType           param_types[3];
 
   if (initialized)
     return;
 
   initialized = TRUE;
-  quark_disposing = g_quark_from_static_string ("gchildable-disposing");
+  quark_flags = g_quark_from_static_string ("gcontainer-flags");
+  quark_children_notify = g_quark_from_static_string ("gcontainerable-children-notify");
 
   param = g_param_spec_object ("child",
                                P_("Child"),
@@ -136,6 +389,13 @@ iface_base (GContainerableIface *iface)
    * @childable: a #Gobject implementing #GChildable
    *
    * Adds @childable to the children list of @containerable.
+   *
+   * The signal is really emitted only when some handler is connected
+   * to it on @containerable. Otherwise the default handler is called
+   * directly, so class closures overridden with
+   * g_signal_override_class_closure() and emission hooks added with
+   * g_signal_add_emission_hook() are bypassed: connect a handler to
+   * the instance if they must run.
    **/
   closure = g_cclosure_new (G_CALLBACK (real_add), (gpointer)0xdeadbeaf, NULL);
   param_types[0] = G_TYPE_OBJECT;
@@ -146,6 +406,8 @@ iface_base (GContainerableIface *iface)
                                 NULL, NULL,
                                 g_cclosure_marshal_VOID__OBJECT,
                                 G_TYPE_NONE, 1, param_types);
+  g_signal_set_va_marshaller (signals[ADD], G_TYPE_CONTAINERABLE,
+                              g_cclosure_marshal_VOID__OBJECTv);
 
   /**
    * GContainerable::remove:
@@ -153,6 +415,9 @@ iface_base (GContainerableIface *iface)
    * @childable: a #Gobject implementing #GChildable
    *
    * Removes @childable from the children list of @containerable.
+   *
+   * As for #GContainerable::add, class closure overrides and emission
+   * hooks are bypassed when no handler is connected.
    **/
   closure = g_cclosure_new (G_CALLBACK (real_remove), (gpointer)0xdeadbeaf, NULL);
   param_types[0] = G_TYPE_OBJECT;
@@ -163,6 +428,84 @@ iface_base (GContainerableIface *iface)
                                    NULL, NULL,
                                    g_cclosure_marshal_VOID__OBJECT,
                                    G_TYPE_NONE, 1, param_types);
+  g_signal_set_va_marshaller (signals[REMOVE], G_TYPE_CONTAINERABLE,
+                              g_cclosure_marshal_VOID__OBJECTv);
+
+  /**
+   * GContainerable::add-many:
+   * @containerable: a #GContainerable
+   * @n_children: number of children in @children
+   * @children: an array of #GObject implementing #GChildable
+   *
+   * Adds all the @children to the children list of @containerable.
+   *
+   * As for #GContainerable::add, class closure overrides and emission
+   * hooks are bypassed when no handler is connected.
+   **/
+  closure = g_cclosure_new (G_CALLBACK (real_add_many), (gpointer)0xdeadbeaf, NULL);
+  param_types[0] = G_TYPE_UINT;
+  param_types[1] = G_TYPE_POINTER;
+  signals[ADD_MANY] = g_signal_newv ("add-many",
+                                     G_TYPE_CONTAINERABLE,
+                                     G_SIGNAL_RUN_FIRST,
+                                     closure,
+                                     NULL, NULL,
+                                     g_cclosure_marshal_VOID__UINT_POINTER,
+                                     G_TYPE_NONE, 2, param_types);
+  g_signal_set_va_marshaller (signals[ADD_MANY], G_TYPE_CONTAINERABLE,
+                              g_cclosure_marshal_VOID__UINT_POINTERv);
+
+  /**
+   * GContainerable::remove-many:
+   * @containerable: a #GContainerable
+   * @n_children: number of children in @children
+   * @children: an array of #GObject implementing #GChildable
+   *
+   * Removes all the @children from the children list of @containerable.
+   *
+   * As for #GContainerable::add, class closure overrides and emission
+   * hooks are bypassed when no handler is connected.
+   **/
+  closure = g_cclosure_new (G_CALLBACK (real_remove_many), (gpointer)0xdeadbeaf, NULL);
+  param_types[0] = G_TYPE_UINT;
+  param_types[1] = G_TYPE_POINTER;
+  signals[REMOVE_MANY] = g_signal_newv ("remove-many",
+                                        G_TYPE_CONTAINERABLE,
+                                        G_SIGNAL_RUN_FIRST,
+                                        closure,
+                                        NULL, NULL,
+                                        g_cclosure_marshal_VOID__UINT_POINTER,
+                                        G_TYPE_NONE, 2, param_types);
+  g_signal_set_va_marshaller (signals[REMOVE_MANY], G_TYPE_CONTAINERABLE,
+                              g_cclosure_marshal_VOID__UINT_POINTERv);
+
+  /**
+   * GContainerable::children-changed:
+   * @containerable: a #GContainerable
+   * @position: index of the first changed child
+   * @removed: number of children removed at @position
+   * @added: number of children added at @position
+   *
+   * The children list of @containerable has changed: @removed children
+   * starting at @position were replaced by @added new ones. While the
+   * notification is frozen by g_containerable_freeze_children_notify(),
+   * all the changes are coalesced in a single emission.
+   *
+   * The positions are computed only when this signal has handlers
+   * connected, so tracking the changes costs nothing otherwise.
+   **/
+  param_types[0] = G_TYPE_UINT;
+  param_types[1] = G_TYPE_UINT;
+  param_types[2] = G_TYPE_UINT;
+  signals[CHILDREN_CHANGED] = g_signal_newv ("children-changed",
+                                             G_TYPE_CONTAINERABLE,
+                                             G_SIGNAL_RUN_LAST,
+                                             NULL,
+                                             NULL, NULL,
+                                             g_cclosure_marshal_generic,
+                                             G_TYPE_NONE, 3, param_types);
+  g_signal_set_va_marshaller (signals[CHILDREN_CHANGED], G_TYPE_CONTAINERABLE,
+                              g_cclosure_marshal_generic_va);
 }
 
 static void
@@ -171,6 +514,14 @@ iface_init (GContainerableIface *iface)
   iface->get_children = get_children;
   iface->add = add;
   iface->remove = remove;
+  iface->foreach = foreach;
+  iface->add_many = add_many;
+  iface->remove_many = remove_many;
+  iface->get_flags = get_flags;
+  iface->get_children_snapshot = get_children_snapshot;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
 }
 
 
@@ -179,12 +530,62 @@ real_add (GContainerable *containerable,
 	  GChildable     *childable,
 	  gpointer        user_data)
 {
-  GContainerableIface *containerable_iface;
-  GContainerable      *old_parent;
+  g_assert (user_data == (gpointer) 0xdeadbeaf);
+
+  if (!add_child (containerable, childable))
+    g_signal_stop_emission (containerable, signals[ADD], 0);
+}
+
+static void
+real_remove (GContainerable *containerable,
+	     GChildable     *childable,
+	     gpointer        user_data)
+{
+  g_assert (user_data == (gpointer) 0xdeadbeaf);
+
+  if (!remove_child (containerable, childable))
+    g_signal_stop_emission (containerable, signals[REMOVE], 0);
+}
+
+static void
+real_add_many (GContainerable *containerable,
+	       guint           n_children,
+	       GChildable    **children,
+	       gpointer        user_data)
+{
+  g_assert (user_data == (gpointer) 0xdeadbeaf);
+
+  if (!add_children (containerable, n_children, children))
+    g_signal_stop_emission (containerable, signals[ADD_MANY], 0);
+}
 
+static void
+real_remove_many (GContainerable *containerable,
+		  guint           n_children,
+		  GChildable    **children,
+		  gpointer        user_data)
+{
   g_assert (user_data == (gpointer) 0xdeadbeaf);
 
-  containerable_iface = G_CONTAINERABLE_GET_IFACE (containerable);
+  if (!remove_children (containerable, n_children, children))
+    g_signal_stop_emission (containerable, signals[REMOVE_MANY], 0);
+}
+
+
+/* The following functions do the real job of the class closures.
+ * They return %FALSE when the signal emission must be stopped. */
+
+static gboolean
+add_child (GContainerable *containerable,
+	   GChildable     *childable)
+{
+  GContainerableIface *containerable_iface;
+  GContainerable      *old_parent;
+  InsertFrame         *frame;
+  gboolean             track;
+  guint                position, span;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
   old_parent = g_childable_get_parent (childable);
 
   if (old_parent != NULL)
@@ -195,39 +596,352 @@ real_add (GContainerable *containerable,
                  g_type_name (G_OBJECT_TYPE (childable)),
                  g_type_name (G_OBJECT_TYPE (containerable)),
                  g_type_name (G_OBJECT_TYPE (old_parent)));
-      return;
+      return TRUE;
     }
 
+  track = _g_containerable_tracks_children (containerable);
+  frame = take_insert (containerable, childable);
 
-  if (containerable_iface->add (containerable, childable))
+  if (frame != NULL)
+    {
+      if (!frame->insert (containerable, childable, frame->position, &position))
+	return FALSE;
+    }
+  /* A container reporting the position spares the walk of find_range() */
+  else if (track && containerable_iface->add_indexed != NULL)
     {
-      g_childable_set_parent (childable, containerable);
+      if (!containerable_iface->add_indexed (containerable, childable, &position))
+	return FALSE;
     }
   else
     {
-      g_signal_stop_emission (containerable, signals[ADD], 0);
+      if (!containerable_iface->add (containerable, childable))
+	return FALSE;
+
+      if (track)
+	track = find_range (containerable, 1, &childable, &position, &span);
     }
+
+  g_childable_set_parent (childable, containerable);
+
+  if (track)
+    children_changed (containerable, position, 0, 1);
+
+  return TRUE;
 }
 
-static void
-real_remove (GContainerable *containerable,
-	     GChildable     *childable,
-	     gpointer        user_data)
+static gboolean
+remove_child (GContainerable *containerable,
+	      GChildable     *childable)
 {
   GContainerableIface *containerable_iface;
+  gboolean             track;
+  guint                position, span;
 
-  g_assert (user_data == (gpointer) 0xdeadbeaf);
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
+  track = _g_containerable_tracks_children (containerable);
+
+  if (track && containerable_iface->remove_indexed != NULL)
+    {
+      if (!containerable_iface->remove_indexed (containerable, childable, &position))
+	return FALSE;
+    }
+  else
+    {
+      /* The position must be looked up before the removal */
+      if (track)
+	track = find_range (containerable, 1, &childable, &position, &span);
+
+      if (!containerable_iface->remove (containerable, childable))
+	return FALSE;
+    }
+
+  g_childable_unparent (childable);
+
+  if (track)
+    children_changed (containerable, position, 1, 0);
+
+  return TRUE;
+}
+
+static gboolean
+add_children (GContainerable *containerable,
+	      guint           n_children,
+	      GChildable    **children)
+{
+  GContainerableIface *containerable_iface;
+  GContainerable      *old_parent;
+  guint                n, position, span;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
 
-  containerable_iface = G_CONTAINERABLE_GET_IFACE (containerable);
+  for (n = 0; n < n_children; ++ n)
+    {
+      old_parent = g_childable_get_parent (children[n]);
+
+      if (old_parent != NULL)
+	{
+	  g_warning ("Attempting to add an object with type %s to a container "
+		     "of type %s, but the object is already inside a container "
+		     "of type %s.",
+		     g_type_name (G_OBJECT_TYPE (children[n])),
+		     g_type_name (G_OBJECT_TYPE (containerable)),
+		     g_type_name (G_OBJECT_TYPE (old_parent)));
+	  return FALSE;
+	}
+    }
+
+  if (!containerable_iface->add_many (containerable, n_children, children))
+    return FALSE;
+
+  for (n = 0; n < n_children; ++ n)
+    g_childable_set_parent (children[n], containerable);
+
+  /* The new children could be not contiguous: notify the whole range
+   * they span, replacing the old children interleaved with them */
+  if (find_range (containerable, n_children, children, &position, &span))
+    children_changed (containerable, position, span - n_children, span);
+
+  return TRUE;
+}
+
+static gboolean
+remove_children (GContainerable *containerable,
+		 guint           n_children,
+		 GChildable    **children)
+{
+  GContainerableIface *containerable_iface;
+  gboolean             track;
+  guint                n, position, span;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      if (g_childable_get_parent (children[n]) != containerable)
+	{
+	  g_warning ("Attempting to remove an object with type %s from a "
+		     "container of type %s, but the object is not inside it.",
+		     g_type_name (G_OBJECT_TYPE (children[n])),
+		     g_type_name (G_OBJECT_TYPE (containerable)));
+	  return FALSE;
+	}
+    }
+
+  track = find_range (containerable, n_children, children, &position, &span);
+
+  if (!containerable_iface->remove_many (containerable, n_children, children))
+    return FALSE;
+
+  for (n = 0; n < n_children; ++ n)
+    g_childable_unparent (children[n]);
+
+  if (track)
+    children_changed (containerable, position, span, span - n_children);
+
+  return TRUE;
+}
+
+
+/* Children-changed tracking. find_range() looks up the smallest range of
+ * positions including all the @children, so it does nothing (returning
+ * %FALSE) if nobody is listening. With get_position() every child is
+ * looked up on its own, otherwise the whole container is walked. Single
+ * adds and removes avoid it on containers implementing add_indexed() and
+ * remove_indexed(). */
+
+static gboolean
+find_range (GContainerable *containerable,
+	    guint           n_children,
+	    GChildable    **children,
+	    guint          *position,
+	    guint          *span)
+{
+  GContainerableIface *containerable_iface;
+  FindData             data;
+  guint                n;
+  gint                 nth;
 
-  if (containerable_iface->remove (containerable, childable))
+  if (!g_signal_has_handler_pending (containerable, signals[CHILDREN_CHANGED], 0, FALSE))
+    return FALSE;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
+  data.first = G_MAXUINT;
+  data.last = 0;
+
+  if (containerable_iface->get_position != NULL)
     {
-      g_childable_unparent (childable);
+      for (n = 0; n < n_children; ++ n)
+	{
+	  nth = containerable_iface->get_position (containerable, children[n]);
+
+	  if (nth < 0)
+	    return FALSE;
+
+	  data.first = MIN (data.first, (guint) nth);
+	  data.last = MAX (data.last, (guint) nth);
+	}
     }
   else
     {
-      g_signal_stop_emission (containerable, signals[REMOVE], 0);
+      data.n_children = n_children;
+      data.children = children;
+      data.set = NULL;
+      data.index = 0;
+      data.n_found = 0;
+
+      if (n_children > 1)
+	{
+	  data.set = g_hash_table_new (NULL, NULL);
+	  for (n = 0; n < n_children; ++ n)
+	    g_hash_table_insert (data.set, children[n], children[n]);
+	}
+
+      containerable_iface->foreach (containerable, (GFunc) find_child, &data);
+
+      if (data.set != NULL)
+	g_hash_table_destroy (data.set);
+
+      if (data.n_found != n_children)
+	return FALSE;
+    }
+
+  *position = data.first;
+  *span = data.last - data.first + 1;
+  return TRUE;
+}
+
+static void
+children_changed (GContainerable *containerable,
+		  guint           position,
+		  guint           removed,
+		  guint           added)
+{
+  ChildrenNotify *notify;
+  guint           start, end;
+
+  notify = g_object_get_qdata ((GObject *) containerable, quark_children_notify);
+
+  if (notify == NULL || notify->freeze_count == 0)
+    {
+      g_signal_emit (containerable, signals[CHILDREN_CHANGED], 0,
+		     position, removed, added);
+      return;
+    }
+
+  if (!notify->pending)
+    {
+      notify->pending = TRUE;
+      notify->position = position;
+      notify->removed = removed;
+      notify->added = added;
+      return;
     }
+
+  /* Merge the new change, expressed on the list yet modified by the
+   * pending one, into a single change on the original list: the merged
+   * range goes from the first to the last position touched by any of
+   * them, and the end of this range is translated back and forth using
+   * the size differences introduced by the two changes. */
+  start = MIN (notify->position, position);
+  end = MAX (notify->position + notify->added, position + removed);
+
+  notify->removed = end - (notify->added - notify->removed) - start;
+  notify->added = end + (added - removed) - start;
+  notify->position = start;
+}
+
+/* Containers reordering their children on their own (without an add or
+ * a remove) use these to notify the change. As in find_range(), the
+ * positions should be computed only if _g_containerable_tracks_children()
+ * returns %TRUE. */
+
+gboolean
+_g_containerable_tracks_children (GContainerable *containerable)
+{
+  return g_signal_has_handler_pending (containerable, signals[CHILDREN_CHANGED], 0, FALSE);
+}
+
+void
+_g_containerable_children_changed (GContainerable *containerable,
+				   guint           position,
+				   guint           removed,
+				   guint           added)
+{
+  if (_g_containerable_tracks_children (containerable))
+    children_changed (containerable, position, removed, added);
+}
+
+
+/* An insertion carries its position in a frame pushed on a per thread
+ * stack for the duration of the "add" emission: the frame is consumed
+ * by the add_child() of the same container and child, so additions made
+ * by the signal handlers, nested insertions and other threads do not
+ * interfere. */
+
+void
+_g_containerable_insert (GContainerable           *containerable,
+			 GChildable               *childable,
+			 GContainerableInsertFunc  insert,
+			 gint                      position)
+{
+  InsertFrame frame;
+
+  frame.containerable = containerable;
+  frame.childable = childable;
+  frame.insert = insert;
+  frame.position = position;
+  frame.outer = g_private_get (&insert_frames);
+
+  g_private_set (&insert_frames, &frame);
+  emit_add (containerable, childable);
+  g_private_set (&insert_frames, frame.outer);
+}
+
+static InsertFrame *
+take_insert (GContainerable *containerable,
+	     GChildable     *childable)
+{
+  InsertFrame *frame;
+
+  for (frame = g_private_get (&insert_frames); frame != NULL; frame = frame->outer)
+    if (frame->containerable == containerable &&
+	frame->childable == childable)
+      {
+	/* Consume it, so a following addition of the same child appends */
+	frame->containerable = NULL;
+	return frame;
+      }
+
+  return NULL;
+}
+
+
+/* The signal machinery (closure invocation and GValue marshalling) is
+ * skipped when no handlers are connected: in this case the emission would
+ * only run the class closure, so calling its job directly is equivalent.
+ * GObject has no way to query for class closure overrides and emission
+ * hooks, so they are not invoked on this fast path: the signal
+ * documentation tells to connect a handler when they are needed. */
+
+static void
+emit_add (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  if (g_signal_has_handler_pending (containerable, signals[ADD], 0, FALSE))
+    g_signal_emit (containerable, signals[ADD], 0, childable);
+  else
+    add_child (containerable, childable);
+}
+
+static void
+emit_remove (GContainerable *containerable,
+	     GChildable     *childable)
+{
+  if (g_signal_has_handler_pending (containerable, signals[REMOVE], 0, FALSE))
+    g_signal_emit (containerable, signals[REMOVE], 0, childable);
+  else
+    remove_child (containerable, childable);
 }
 
 
@@ -257,30 +971,564 @@ remove (GContainerable *containerable,
   return FALSE;
 }
 
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GSList *children;
+
+  children = G_CONTAINERABLE_PEEK_IFACE (containerable)->get_children (containerable);
 
-/**
- * g_containerable_add:
- * @containerable: a #GContainerable
- * @childable: a #Gobject implementing #GChildable
- *
- * Emits a #GContainerable::add signal on @containerable
- * passing @childable as argument.
- *
- * A #GChildable implemented object may be added to only one
- * container at a time; you can't place the same child inside
- * two different containers.
- **/
-void
-g_containerable_add (GContainerable *containerable,
-		     GChildable     *childable)
+  while (children)
+    {
+      if (children->data)
+	func (children->data, user_data);
+
+      children = g_slist_delete_link (children, children);
+    }
+}
+
+static gboolean
+add_many (GContainerable *containerable,
+	  guint           n_children,
+	  GChildable    **children)
 {
-  g_return_if_fail (G_IS_CONTAINERABLE (containerable));
-  g_return_if_fail (G_IS_CHILDABLE (childable));
+  GContainerableIface *containerable_iface;
+  guint                n;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
 
-  g_signal_emit (containerable, signals[ADD], 0, childable);
+  for (n = 0; n < n_children; ++ n)
+    if (!containerable_iface->add (containerable, children[n]))
+      {
+	/* All or nothing: roll back the children yet added */
+	while (n --)
+	  containerable_iface->remove (containerable, children[n]);
+
+	return FALSE;
+      }
+
+  return TRUE;
 }
 
-/**
+static gboolean
+remove_many (GContainerable *containerable,
+	     guint           n_children,
+	     GChildable    **children)
+{
+  GContainerableIface *containerable_iface;
+  guint                n;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
+
+  for (n = 0; n < n_children; ++ n)
+    if (!containerable_iface->remove (containerable, children[n]))
+      {
+	/* All or nothing: put back the children yet removed */
+	while (n --)
+	  containerable_iface->add (containerable, children[n]);
+
+	return FALSE;
+      }
+
+  return TRUE;
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  guint *flags;
+
+  /* The same quark is used by the GChildable default method */
+  flags = g_object_get_qdata ((GObject *) containerable, quark_flags);
+
+  if (flags == NULL)
+    {
+      flags = g_new0 (guint, 1);
+      g_object_set_qdata_full ((GObject *) containerable, quark_flags,
+			       flags, g_free);
+    }
+
+  return flags;
+}
+
+static GPtrArray *
+get_children_snapshot (GContainerable *containerable)
+{
+  GPtrArray *snapshot;
+
+  snapshot = g_ptr_array_new_with_free_func (g_object_unref);
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) snapshot_child,
+						      snapshot);
+  return snapshot;
+}
+
+static guint
+n_children (GContainerable *containerable)
+{
+  guint count = 0;
+
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) count_child,
+						      &count);
+  return count;
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  FindData data;
+
+  data.n_children = 1;
+  data.children = &childable;
+  data.set = NULL;
+  data.index = 0;
+  data.n_found = 0;
+
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) find_child,
+						      &data);
+  return data.n_found > 0;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  NthData data;
+
+  data.index = 0;
+  data.nth = nth;
+  data.childable = NULL;
+
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) nth_child,
+						      &data);
+  return data.childable;
+}
+
+static void
+snapshot_child (GObject   *child,
+		GPtrArray *snapshot)
+{
+  g_ptr_array_add (snapshot, g_object_ref (child));
+}
+
+/* Emits @signal_id on every child of @containerable. The parameters
+ * are collected only once by the caller in @instance_and_params, whose
+ * first slot is reused for each child. Returns %TRUE if the signal was
+ * emitted at least once. */
+
+static gboolean
+propagate (GContainerable *containerable,
+	   guint           signal_id,
+	   GQuark          detail,
+	   GValue         *instance_and_params,
+	   GValue         *return_value)
+{
+  PropagateData data;
+
+  data.signal_id = signal_id;
+  data.detail = detail;
+  data.instance_and_params = instance_and_params;
+  data.return_value = return_value;
+  data.emitted = FALSE;
+
+  g_value_init (instance_and_params, G_TYPE_OBJECT);
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) propagate_child,
+						      &data);
+  g_value_unset (instance_and_params);
+
+  return data.emitted;
+}
+
+/* Same as propagate(), but the signal is emitted on all the descendants
+ * of @containerable that are instances of @itype. The tree is walked with
+ * an explicit stack, so the C stack usage does not depend on the depth.
+ *
+ * Every object pushed on the stack is also added to @visited, that holds
+ * a reference to it until the end of the walk: this avoids visiting the
+ * same object twice, so the walk terminates also on cyclic trees, and
+ * keeps the objects alive while the handlers change the tree. */
+
+static gboolean
+propagate_deep (GContainerable *containerable,
+		GTraverseType   order,
+		GType           itype,
+		guint           signal_id,
+		GQuark          detail,
+		GValue         *instance_and_params,
+		GValue         *return_value)
+{
+  GArray     *stack;
+  GHashTable *visited;
+  GPtrArray  *scratch;
+  DeepItem   *top;
+  GObject    *object;
+  gboolean    emitted;
+
+  stack = g_array_new (FALSE, FALSE, sizeof (DeepItem));
+  visited = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  scratch = g_ptr_array_new ();
+  emitted = FALSE;
+
+  g_hash_table_insert (visited, g_object_ref (containerable), NULL);
+  push_children (stack, visited, scratch, containerable);
+
+  g_value_init (instance_and_params, G_TYPE_OBJECT);
+
+  while (stack->len > 0)
+    {
+      top = &g_array_index (stack, DeepItem, stack->len - 1);
+      object = top->object;
+
+      /* In post-order a container is left on the stack, below its
+       * children, until all of them have been processed */
+      if (order == G_POST_ORDER && !top->expanded &&
+	  G_IS_CONTAINERABLE_CACHED (object))
+	{
+	  top->expanded = TRUE;
+	  push_children (stack, visited, scratch, (GContainerable *) object);
+	  continue;
+	}
+
+      g_array_set_size (stack, stack->len - 1);
+
+      if (g_type_is_a (G_OBJECT_TYPE (object), itype))
+	{
+	  g_value_set_object (instance_and_params, object);
+	  g_signal_emitv (instance_and_params, signal_id, detail, return_value);
+	  emitted = TRUE;
+	}
+
+      if (order == G_PRE_ORDER && G_IS_CONTAINERABLE_CACHED (object))
+	push_children (stack, visited, scratch, (GContainerable *) object);
+    }
+
+  g_value_unset (instance_and_params);
+
+  g_ptr_array_free (scratch, TRUE);
+  g_hash_table_destroy (visited);
+  g_array_free (stack, TRUE);
+
+  return emitted;
+}
+
+static void
+push_children (GArray         *stack,
+	       GHashTable     *visited,
+	       GPtrArray      *scratch,
+	       GContainerable *containerable)
+{
+  DeepItem item;
+  guint    n;
+
+  g_ptr_array_set_size (scratch, 0);
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) collect_child,
+						      scratch);
+
+  /* Pushed in reverse order, so the first child is popped first */
+  item.expanded = FALSE;
+  for (n = scratch->len; n > 0; -- n)
+    {
+      item.object = g_ptr_array_index (scratch, n - 1);
+
+      if (g_hash_table_lookup_extended (visited, item.object, NULL, NULL))
+	continue;
+
+      g_hash_table_insert (visited, g_object_ref (item.object), NULL);
+      g_array_append_val (stack, item);
+    }
+}
+
+/* Collects the parameters in @var_args only once and emits the signal
+ * on the children (or on the whole subtree if @deep is %TRUE) of
+ * @containerable. The return value of the last emission is stored in
+ * the location at the end of @var_args. */
+
+static void
+propagate_valist (GContainerable *containerable,
+		  gboolean        deep,
+		  GTraverseType   order,
+		  guint           signal_id,
+		  GQuark          detail,
+		  va_list         var_args)
+{
+  GSignalQuery query;
+  GValue      *instance_and_params;
+  GValue       return_value = { 0, };
+  GType        return_type;
+  gboolean     emitted;
+  gchar       *error;
+  guint        n;
+
+  g_signal_query (signal_id, &query);
+  g_return_if_fail (query.signal_id != 0);
+
+  instance_and_params = g_newa (GValue, query.n_params + 1);
+  memset (instance_and_params, 0, sizeof (GValue) * (query.n_params + 1));
+
+  for (n = 0; n < query.n_params; ++ n)
+    {
+      GType    param_type = query.param_types[n] & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+      gboolean static_scope = query.param_types[n] & G_SIGNAL_TYPE_STATIC_SCOPE;
+
+      error = NULL;
+      G_VALUE_COLLECT_INIT (instance_and_params + n + 1, param_type, var_args,
+			    static_scope ? G_VALUE_NOCOPY_CONTENTS : 0, &error);
+
+      if (error != NULL)
+	{
+	  g_warning ("%s: %s", G_STRLOC, error);
+	  g_free (error);
+
+	  /* The remaining arguments cannot be trusted: drop all of them */
+	  while (n --)
+	    g_value_unset (instance_and_params + n + 1);
+
+	  return;
+	}
+    }
+
+  return_type = query.return_type & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+
+  if (return_type != G_TYPE_NONE)
+    g_value_init (&return_value, return_type);
+
+  if (deep)
+    emitted = propagate_deep (containerable, order, query.itype,
+			      signal_id, detail, instance_and_params,
+			      return_type != G_TYPE_NONE ? &return_value : NULL);
+  else
+    emitted = propagate (containerable, signal_id, detail, instance_and_params,
+			 return_type != G_TYPE_NONE ? &return_value : NULL);
+
+  if (emitted && return_type != G_TYPE_NONE)
+    {
+      gboolean static_scope = query.return_type & G_SIGNAL_TYPE_STATIC_SCOPE;
+
+      error = NULL;
+      G_VALUE_LCOPY (&return_value, var_args,
+		     static_scope ? G_VALUE_NOCOPY_CONTENTS : 0, &error);
+
+      if (error != NULL)
+	{
+	  g_warning ("%s: %s", G_STRLOC, error);
+	  g_free (error);
+	}
+    }
+
+  if (return_type != G_TYPE_NONE)
+    g_value_unset (&return_value);
+
+  for (n = 0; n < query.n_params; ++ n)
+    g_value_unset (instance_and_params + n + 1);
+}
+
+/* The GValue counterpart of propagate_valist() */
+
+static void
+propagate_values (GContainerable *containerable,
+		  gboolean        deep,
+		  GTraverseType   order,
+		  guint           signal_id,
+		  GQuark          detail,
+		  const GValue   *params,
+		  GValue         *return_value)
+{
+  GSignalQuery query;
+  GValue      *instance_and_params;
+  GValue       dummy_value = { 0, };
+  GType        return_type;
+
+  g_signal_query (signal_id, &query);
+  g_return_if_fail (query.signal_id != 0);
+  g_return_if_fail (query.n_params == 0 || params != NULL);
+
+  /* The parameters are only read by g_signal_emitv(),
+   * so a shallow copy of the GValue structs is enough */
+  instance_and_params = g_newa (GValue, query.n_params + 1);
+  memset (instance_and_params, 0, sizeof (GValue));
+  if (query.n_params > 0)
+    memcpy (instance_and_params + 1, params, sizeof (GValue) * query.n_params);
+
+  return_type = query.return_type & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+
+  if (return_type != G_TYPE_NONE && return_value == NULL)
+    {
+      g_value_init (&dummy_value, return_type);
+      return_value = &dummy_value;
+    }
+
+  if (deep)
+    propagate_deep (containerable, order, query.itype,
+		    signal_id, detail, instance_and_params, return_value);
+  else
+    propagate (containerable, signal_id, detail, instance_and_params,
+	       return_value);
+
+  if (return_value == &dummy_value)
+    g_value_unset (&dummy_value);
+}
+
+
+static void
+find_child (GChildable *childable,
+	    FindData   *data)
+{
+  gboolean found;
+
+  if (data->set != NULL)
+    found = g_hash_table_lookup (data->set, childable) != NULL;
+  else
+    found = childable == data->children[0];
+
+  if (found)
+    {
+      if (data->n_found == 0)
+	data->first = data->index;
+
+      data->last = data->index;
+      ++ data->n_found;
+    }
+
+  ++ data->index;
+}
+
+static void
+count_child (GChildable *childable,
+	     guint      *count)
+{
+  ++ *count;
+}
+
+static void
+nth_child (GChildable *childable,
+	   NthData    *data)
+{
+  if (data->index == data->nth)
+    data->childable = childable;
+
+  ++ data->index;
+}
+
+static void
+propagate_child (GChildable    *childable,
+		 PropagateData *data)
+{
+  g_value_set_object (data->instance_and_params, childable);
+  g_signal_emitv (data->instance_and_params,
+		  data->signal_id, data->detail, data->return_value);
+  data->emitted = TRUE;
+}
+
+static void
+collect_child (GChildable *childable,
+	       GPtrArray  *children)
+{
+  g_ptr_array_add (children, childable);
+}
+
+static void
+dispose_child (GChildable     *childable,
+	       GContainerable *containerable)
+{
+  /* Keep @childable alive after its removal: the last reference is
+   * dropped by the outermost g_containerable_dispose(), so the dispose
+   * of @childable does not nest inside the one of @containerable */
+  g_object_ref (childable);
+  emit_remove (containerable, childable);
+  g_queue_push_tail (g_private_get (&dispose_worklist), childable);
+}
+
+/* Releases up to chunk_size objects of the worklist of @job, which is
+ * installed as the current worklist so the children of the disposed
+ * containers are appended to it instead of being released now */
+
+static gboolean
+dispose_chunk (DisposeJob *job)
+{
+  GQueue  *previous;
+  GObject *object;
+  guint    n;
+
+  previous = g_private_get (&dispose_worklist);
+  g_private_set (&dispose_worklist, &job->worklist);
+
+  for (n = 0; n < job->chunk_size; ++ n)
+    {
+      object = g_queue_pop_head (&job->worklist);
+
+      if (object == NULL)
+	break;
+
+      g_object_unref (object);
+      ++ job->n_disposed;
+    }
+
+  g_private_set (&dispose_worklist, previous);
+
+  if (job->progress)
+    job->progress (job->n_disposed, job->worklist.length, job->user_data);
+
+  return job->worklist.length > 0 ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static void
+dispose_job_free (DisposeJob *job)
+{
+  /* The source could be destroyed before the end of the job:
+   * release the remaining objects in one go */
+  if (job->worklist.length > 0)
+    {
+      job->chunk_size = G_MAXUINT;
+      dispose_chunk (job);
+    }
+
+  if (job->notify)
+    job->notify (job->user_data);
+
+  g_free (job);
+}
+
+
+/**
+ * g_containerable_add:
+ * @containerable: a #GContainerable
+ * @childable: a #Gobject implementing #GChildable
+ *
+ * Emits a #GContainerable::add signal on @containerable
+ * passing @childable as argument.
+ *
+ * A #GChildable implemented object may be added to only one
+ * container at a time; you can't place the same child inside
+ * two different containers.
+ *
+ * Checking that @childable has no parent and setting the parent are
+ * not a single atomic step, even on a thread safe container: the
+ * caller must ensure that no other thread is adding or removing
+ * @childable at the same time.
+ *
+ * When no handlers are connected to #GContainerable::add, the default
+ * handler is called directly without going through the signal machinery,
+ * so class closure overrides and emission hooks are not invoked.
+ **/
+void
+g_containerable_add (GContainerable *containerable,
+		     GChildable     *childable)
+{
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+
+  emit_add (containerable, childable);
+}
+
+/**
  * g_containerable_remove:
  * @containerable: a #GContainerable
  * @childable: a #Gobject implementing #GChildable
@@ -298,15 +1546,320 @@ g_containerable_add (GContainerable *containerable,
  * efficient to simply destroy it directly using g_object_unref()
  * since this will remove it from the container and help break any
  * circular reference count cycles.
+ *
+ * @childable is taken out of @containerable before being unparented,
+ * so no other thread must add or remove @childable at the same time.
+ *
+ * When no handlers are connected to #GContainerable::remove, the default
+ * handler is called directly without going through the signal machinery,
+ * so class closure overrides and emission hooks are not invoked.
  **/
 void
 g_containerable_remove (GContainerable *containerable,
 			GChildable     *childable)
 {
-  g_return_if_fail (G_IS_CONTAINERABLE (containerable));
-  g_return_if_fail (G_IS_CHILDABLE (childable));
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+
+  emit_remove (containerable, childable);
+}
+
+/**
+ * g_containerable_add_unchecked:
+ * @containerable: a #GContainerable
+ * @childable: a #Gobject implementing #GChildable
+ *
+ * Same as g_containerable_add(), but the arguments are not validated
+ * unless the library is configured with <option>--enable-debug</option>.
+ * Use it only in trusted code, where the types are known in advance.
+ **/
+void
+g_containerable_add_unchecked (GContainerable *containerable,
+			       GChildable     *childable)
+{
+#ifdef GCONTAINER_ENABLE_DEBUG
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+#endif
 
-  g_signal_emit (containerable, signals[REMOVE], 0, childable);
+  emit_add (containerable, childable);
+}
+
+/**
+ * g_containerable_remove_unchecked:
+ * @containerable: a #GContainerable
+ * @childable: a #Gobject implementing #GChildable
+ *
+ * Same as g_containerable_remove(), but the arguments are not validated
+ * unless the library is configured with <option>--enable-debug</option>.
+ * Use it only in trusted code, where the types are known in advance.
+ **/
+void
+g_containerable_remove_unchecked (GContainerable *containerable,
+				  GChildable     *childable)
+{
+#ifdef GCONTAINER_ENABLE_DEBUG
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+#endif
+
+  emit_remove (containerable, childable);
+}
+
+/**
+ * g_containerable_add_many:
+ * @containerable: a #GContainerable
+ * @n_children: number of children in @children
+ * @children: an array of #GObject implementing #GChildable
+ * @emission: how the listeners must be notified
+ *
+ * Adds all the @children to @containerable at once, in the order they
+ * appear in the array.
+ *
+ * If @emission is %G_CONTAINERABLE_EMIT_EACH, this is the same as calling
+ * g_containerable_add() on every child. If it is %G_CONTAINERABLE_EMIT_BATCH,
+ * a single #GContainerable::add-many signal is emitted for the whole batch:
+ * the children are added all together or, if any of them cannot be added
+ * (for instance because it is yet inside a container), none of them is.
+ * As for g_containerable_add(), the signal machinery is skipped when no
+ * handler is connected to #GContainerable::add-many.
+ *
+ * @children must not contain the same object more than once, and no
+ * other thread must add or remove any of @children at the same time.
+ **/
+void
+g_containerable_add_many (GContainerable        *containerable,
+			  guint                  n_children,
+			  GChildable           **children,
+			  GContainerableEmission emission)
+{
+  guint n;
+
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (n_children == 0 || children != NULL);
+
+  for (n = 0; n < n_children; ++ n)
+    g_return_if_fail (G_IS_CHILDABLE_CACHED (children[n]));
+
+  if (emission == G_CONTAINERABLE_EMIT_EACH)
+    {
+      for (n = 0; n < n_children; ++ n)
+	emit_add (containerable, children[n]);
+    }
+  else if (n_children == 0)
+    {
+      return;
+    }
+  else if (g_signal_has_handler_pending (containerable, signals[ADD_MANY], 0, FALSE))
+    {
+      g_signal_emit (containerable, signals[ADD_MANY], 0, n_children, children);
+    }
+  else
+    {
+      add_children (containerable, n_children, children);
+    }
+}
+
+/**
+ * g_containerable_remove_many:
+ * @containerable: a #GContainerable
+ * @n_children: number of children in @children
+ * @children: an array of #GObject implementing #GChildable
+ * @emission: how the listeners must be notified
+ *
+ * Removes all the @children from @containerable at once.
+ *
+ * If @emission is %G_CONTAINERABLE_EMIT_EACH, this is the same as calling
+ * g_containerable_remove() on every child. If it is
+ * %G_CONTAINERABLE_EMIT_BATCH, a single #GContainerable::remove-many signal
+ * is emitted for the whole batch: the children are removed all together
+ * or, if any of them is not inside @containerable, none of them is.
+ * As for g_containerable_remove(), the signal machinery is skipped when
+ * no handler is connected to #GContainerable::remove-many.
+ *
+ * As for g_containerable_remove(), the container reference on every child
+ * is dropped, so removing the children can destroy them. The children
+ * are kept alive until the #GContainerable::remove-many handlers return.
+ *
+ * @children must not contain the same object more than once, and no
+ * other thread must add or remove any of @children at the same time.
+ **/
+void
+g_containerable_remove_many (GContainerable        *containerable,
+			     guint                  n_children,
+			     GChildable           **children,
+			     GContainerableEmission emission)
+{
+  guint n;
+
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (n_children == 0 || children != NULL);
+
+  for (n = 0; n < n_children; ++ n)
+    g_return_if_fail (G_IS_CHILDABLE_CACHED (children[n]));
+
+  if (emission == G_CONTAINERABLE_EMIT_EACH)
+    {
+      for (n = 0; n < n_children; ++ n)
+	emit_remove (containerable, children[n]);
+    }
+  else if (n_children == 0)
+    {
+      return;
+    }
+  else if (g_signal_has_handler_pending (containerable, signals[REMOVE_MANY], 0, FALSE))
+    {
+      for (n = 0; n < n_children; ++ n)
+	g_object_ref (children[n]);
+
+      g_signal_emit (containerable, signals[REMOVE_MANY], 0, n_children, children);
+
+      for (n = 0; n < n_children; ++ n)
+	g_object_unref (children[n]);
+    }
+  else
+    {
+      remove_children (containerable, n_children, children);
+    }
+}
+
+/**
+ * g_containerable_move:
+ * @containerable: a #GContainerable
+ * @childable: a #GObject implementing #GChildable, inside another container
+ *
+ * Moves @childable from its current parent to @containerable.
+ *
+ * Unlike g_childable_reparent(), when both containers provide the same
+ * #GContainerableIface.move_child method (for instance, two #GContainer)
+ * the move is done in a single step: @childable never appears without a
+ * parent, so it cannot be added elsewhere in the meantime, and no
+ * reference is taken or released. Thread safe containers are both
+ * locked for the whole step, so concurrent readers see @childable in
+ * one of the two containers only.
+ *
+ * In this case #GContainerable::add and #GContainerable::remove are not
+ * emitted: only #GChildable::parent-set on @childable and
+ * #GContainerable::children-changed on both containers are.
+ * Otherwise g_childable_reparent() is used.
+ *
+ * Returns: %TRUE if @childable has been moved, %FALSE if another thread
+ *          removed or moved it in the meantime
+ **/
+gboolean
+g_containerable_move (GContainerable *containerable,
+		      GChildable     *childable)
+{
+  GContainerableIface *containerable_iface;
+  GContainerableIface *old_iface;
+  GContainerable      *old_parent;
+  gboolean             track;
+  guint                position, span;
+
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), FALSE);
+  g_return_val_if_fail (G_IS_CHILDABLE_CACHED (childable), FALSE);
+
+  old_parent = g_childable_get_parent (childable);
+
+  g_return_val_if_fail (old_parent != NULL, FALSE);
+
+  if (old_parent == containerable)
+    return TRUE;
+
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
+  old_iface = G_CONTAINERABLE_PEEK_IFACE (old_parent);
+
+  if (containerable_iface->move_child == NULL ||
+      containerable_iface->move_child != old_iface->move_child)
+    {
+      g_childable_reparent (childable, containerable);
+      return g_childable_get_parent (childable) == containerable;
+    }
+
+  /* The position must be looked up before the removal */
+  track = find_range (old_parent, 1, &childable, &position, &span);
+
+  if (!containerable_iface->move_child (containerable, childable, old_parent))
+    return FALSE;
+
+  if (track)
+    children_changed (old_parent, position, 1, 0);
+
+  if (find_range (containerable, 1, &childable, &position, &span))
+    children_changed (containerable, position, 0, 1);
+
+  if (G_UNLIKELY (parent_set_signal == 0))
+    parent_set_signal = g_signal_lookup ("parent-set", G_TYPE_CHILDABLE);
+
+  g_signal_emit (childable, parent_set_signal, 0, old_parent);
+  return TRUE;
+}
+
+/**
+ * g_containerable_freeze_children_notify:
+ * @containerable: a #GContainerable
+ *
+ * Increases the freeze count on @containerable. While the freeze count is
+ * not zero, the emission of #GContainerable::children-changed is delayed
+ * and all the changes are coalesced, so only one signal is emitted when
+ * the container is thawed. The #GContainerable::add and
+ * #GContainerable::remove signals are not affected.
+ *
+ * This is the children list counterpart of g_object_freeze_notify():
+ * every call must be matched by a call to
+ * g_containerable_thaw_children_notify().
+ **/
+void
+g_containerable_freeze_children_notify (GContainerable *containerable)
+{
+  ChildrenNotify *notify;
+
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+
+  notify = g_object_get_qdata ((GObject *) containerable, quark_children_notify);
+
+  if (notify == NULL)
+    {
+      notify = g_new0 (ChildrenNotify, 1);
+      g_object_set_qdata_full ((GObject *) containerable, quark_children_notify,
+			       notify, g_free);
+    }
+
+  ++ notify->freeze_count;
+}
+
+/**
+ * g_containerable_thaw_children_notify:
+ * @containerable: a #GContainerable
+ *
+ * Reverts the effect of a previous call to
+ * g_containerable_freeze_children_notify(). When the freeze count drops to
+ * zero, a single #GContainerable::children-changed signal covering all
+ * the changes made in the meantime is emitted, if any change was made.
+ **/
+void
+g_containerable_thaw_children_notify (GContainerable *containerable)
+{
+  ChildrenNotify *notify;
+
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+
+  notify = g_object_get_qdata ((GObject *) containerable, quark_children_notify);
+
+  if (notify == NULL || notify->freeze_count == 0)
+    {
+      g_warning ("%s: children notification of `%s' instance `%p' "
+		 "is not frozen",
+		 G_STRLOC, G_OBJECT_TYPE_NAME (containerable), containerable);
+      return;
+    }
+
+  if (-- notify->freeze_count > 0 || !notify->pending)
+    return;
+
+  notify->pending = FALSE;
+  g_signal_emit (containerable, signals[CHILDREN_CHANGED], 0,
+		 notify->position, notify->removed, notify->added);
 }
 
 /**
@@ -321,9 +1874,100 @@ g_containerable_remove (GContainerable *containerable,
 GSList *
 g_containerable_get_children (GContainerable *containerable)
 {
-  g_return_val_if_fail (G_IS_CONTAINERABLE (containerable), NULL);
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), NULL);
+
+  return G_CONTAINERABLE_PEEK_IFACE (containerable)->get_children (containerable);
+}
+
+/**
+ * g_containerable_get_children_snapshot:
+ * @containerable: a #GContainerable
+ *
+ * Gets an immutable array of the children of @containerable.
+ *
+ * Unlike g_containerable_get_children(), the array is not necessarily
+ * built on every call: containers such as #GContainer cache it and give
+ * the same array to all the callers until a child is added or removed.
+ * The array holds a reference to every child, so it stays valid after
+ * the container is modified and can be passed to other threads.
+ *
+ * The array must not be modified. Release it with g_ptr_array_unref()
+ * when no longer needed.
+ *
+ * Returns: a new reference to the children array, or %NULL on errors
+ **/
+GPtrArray *
+g_containerable_get_children_snapshot (GContainerable *containerable)
+{
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), NULL);
+
+  return G_CONTAINERABLE_PEEK_IFACE (containerable)->get_children_snapshot (containerable);
+}
+
+/**
+ * g_containerable_n_children:
+ * @containerable: a #GContainerable
+ *
+ * Gets the number of children of @containerable, without building
+ * the list returned by g_containerable_get_children().
+ *
+ * Returns: the number of children
+ **/
+guint
+g_containerable_n_children (GContainerable *containerable)
+{
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), 0);
+
+  return G_CONTAINERABLE_PEEK_IFACE (containerable)->n_children (containerable);
+}
+
+/**
+ * g_containerable_contains:
+ * @containerable: a #GContainerable
+ * @childable: a #GObject implementing #GChildable
+ *
+ * Checks if @childable is one of the children of @containerable.
+ *
+ * Returns: %TRUE if @childable is inside @containerable
+ **/
+gboolean
+g_containerable_contains (GContainerable *containerable,
+			  GChildable     *childable)
+{
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), FALSE);
+  g_return_val_if_fail (G_IS_CHILDABLE_CACHED (childable), FALSE);
+
+  return G_CONTAINERABLE_PEEK_IFACE (containerable)->contains (containerable,
+							      childable);
+}
+
+/**
+ * g_containerable_get_nth:
+ * @containerable: a #GContainerable
+ * @nth: the position of the child, starting from 0
+ *
+ * Gets the child of @containerable at position @nth, in the same
+ * order used by g_containerable_foreach(). No reference is added to
+ * the returned child: on a thread safe container, use
+ * g_containerable_get_children_snapshot() if other threads could
+ * remove it in the meantime.
+ *
+ * The cost depends on the implementation: the default method walks the
+ * children, so it is O(n), while #GContainer, #GKeyedContainer, #GSlot
+ * and #GSortedContainer look up a balanced tree in O(log n). To visit
+ * all the children, prefer g_containerable_foreach() or
+ * g_containerable_get_children_snapshot() to calling this function in
+ * a loop.
+ *
+ * Returns: the child at @nth or %NULL if @nth is out of range
+ **/
+GChildable *
+g_containerable_get_nth (GContainerable *containerable,
+			 guint           nth)
+{
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), NULL);
 
-  return G_CONTAINERABLE_GET_IFACE (containerable)->get_children (containerable);
+  return G_CONTAINERABLE_PEEK_IFACE (containerable)->get_nth (containerable, nth);
 }
 
 /**
@@ -332,27 +1976,46 @@ g_containerable_get_children (GContainerable *containerable)
  * @callback: a callback
  * @user_data: callback user data
  * 
- * Invokes @callback on each child of @containerable.
+ * Invokes @callback on each child of @containerable. @callback can add
+ * or remove children: a child removed before being reached is not
+ * visited, unless @containerable walks a snapshot of its children.
  **/
 void
 g_containerable_foreach (GContainerable *containerable,
 			 GCallback       callback,
 			 gpointer        user_data)
 {
-  GSList *children;
-
-  g_return_if_fail (G_IS_CONTAINERABLE (containerable));
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
   g_return_if_fail (callback != NULL);
 
-  children = g_containerable_get_children (containerable);
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) callback,
+						      user_data);
+}
 
-  while (children)
-    {
-      if (children->data)
-        ((void (*) (gpointer, gpointer)) callback) (children->data, user_data);
+/**
+ * g_containerable_foreach_unchecked:
+ * @containerable: a #GContainerable
+ * @callback: a callback
+ * @user_data: callback user data
+ *
+ * Same as g_containerable_foreach(), but the arguments are not validated
+ * unless the library is configured with <option>--enable-debug</option>.
+ * Use it only in trusted code, where the types are known in advance.
+ **/
+void
+g_containerable_foreach_unchecked (GContainerable *containerable,
+				   GCallback       callback,
+				   gpointer        user_data)
+{
+#ifdef GCONTAINER_ENABLE_DEBUG
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (callback != NULL);
+#endif
 
-      children = g_slist_delete_link (children, children);
-    }
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) callback,
+						      user_data);
 }
 
 /**
@@ -364,8 +2027,9 @@ g_containerable_foreach (GContainerable *containerable,
  *       return value. If the return type of the signal is G_TYPE_NONE, the return
  *       value location can be omitted.
  *
- * Emits the specified signal to all the children of @containerable
- * using g_signal_emit_valist() calls.
+ * Emits the specified signal to all the children of @containerable.
+ * The parameters are collected only once, as described in
+ * g_containerable_propagate_valist().
  **/
 void
 g_containerable_propagate (GContainerable *containerable,
@@ -388,8 +2052,9 @@ g_containerable_propagate (GContainerable *containerable,
  *       for the return value. If the return type of the signal is G_TYPE_NONE,
  *       the return value location can be omitted.
  *
- * Emits the specified signal to all the children of @containerable
- * using g_signal_emit_valist() calls.
+ * Emits the specified signal to all the children of @containerable.
+ * The parameters are collected only once, as described in
+ * g_containerable_propagate_valist().
  **/
 void
 g_containerable_propagate_by_name (GContainerable *containerable,
@@ -422,8 +2087,13 @@ g_containerable_propagate_by_name (GContainerable *containerable,
  *            location for the return value. If the return type of the signal
  *            is G_TYPE_NONE, the return value location can be omitted.
  *
- * Emits the specified signal to all the children of @containerable
- * using g_signal_emit_valist() calls.
+ * Emits the specified signal to all the children of @containerable.
+ *
+ * @var_args is collected only once and the resulting values are shared
+ * by all the emissions, so the cost of the argument parsing does not
+ * grow with the number of children. If the signal
+ * returns a value, the one returned by the last child is stored
+ * in the return location.
  **/
 void
 g_containerable_propagate_valist (GContainerable *containerable,
@@ -431,23 +2101,213 @@ g_containerable_propagate_valist (GContainerable *containerable,
                                   GQuark          detail,
                                   va_list         var_args)
 {
-  GSList *children;
-  va_list var_copy;
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
 
-  g_return_if_fail (G_IS_CONTAINERABLE (containerable));
+  propagate_valist (containerable, FALSE, G_PRE_ORDER,
+		    signal_id, detail, var_args);
+}
 
-  children = g_containerable_get_children (containerable);
+/**
+ * g_containerable_propagatev:
+ * @containerable: a #GContainerable
+ * @signal_id: the signal id
+ * @detail: the detail
+ * @params: an array of the parameters to be passed to the signal, without
+ *          the instance, or %NULL if the signal has no parameters
+ * @return_value: location to store the return value or %NULL
+ *
+ * Emits the specified signal to all the children of @containerable
+ * using g_signal_emitv() calls. This is the fastest way to broadcast
+ * a signal, as the parameters are yet collected in @params and are
+ * shared by all the emissions.
+ *
+ * If the signal returns a value, @return_value must be initialized to
+ * the return type of the signal and will contain the value returned by
+ * the last child. Unlike g_signal_emitv(), @return_value can be %NULL
+ * also for signals returning a value.
+ **/
+void
+g_containerable_propagatev (GContainerable *containerable,
+                            guint           signal_id,
+                            GQuark          detail,
+                            const GValue   *params,
+                            GValue         *return_value)
+{
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
 
-  while (children)
-    {
-      if (children->data)
-	{
-	  G_VA_COPY (var_copy, var_args);
-	  g_signal_emit_valist (children->data, signal_id, detail, var_copy);
-	}
+  propagate_values (containerable, FALSE, G_PRE_ORDER,
+		    signal_id, detail, params, return_value);
+}
 
-      children = g_slist_delete_link (children, children);
-    }
+/**
+ * g_containerable_propagate_deep:
+ * @containerable: a #GContainerable
+ * @order: %G_PRE_ORDER or %G_POST_ORDER
+ * @signal_id: the signal id
+ * @detail: the detail
+ * @...: parameters to be passed to the signal, followed by a location for the
+ *       return value. If the return type of the signal is G_TYPE_NONE, the return
+ *       value location can be omitted.
+ *
+ * Emits the specified signal to all the descendants of @containerable,
+ * that is its children, the children of the children that implement
+ * #GContainerable and so on. See g_containerable_propagate_deep_valist()
+ * for details.
+ **/
+void
+g_containerable_propagate_deep (GContainerable *containerable,
+                                GTraverseType   order,
+                                guint           signal_id,
+                                GQuark          detail,
+                                ...)
+{
+  va_list var_args;
+
+  va_start (var_args, detail);
+  g_containerable_propagate_deep_valist (containerable, order,
+					 signal_id, detail, var_args);
+  va_end (var_args);
+}
+
+/**
+ * g_containerable_propagate_deep_valist:
+ * @containerable: a #GContainerable
+ * @order: %G_PRE_ORDER or %G_POST_ORDER
+ * @signal_id: the signal id
+ * @detail: the detail
+ * @var_args: a list of parameters to be passed to the signal, followed by a
+ *            location for the return value. If the return type of the signal
+ *            is G_TYPE_NONE, the return value location can be omitted.
+ *
+ * Emits the specified signal to all the descendants of @containerable.
+ * With %G_PRE_ORDER a container receives the signal before its children,
+ * with %G_POST_ORDER after them. Only the descendants that are instances
+ * of the type the signal belongs to are emitted, so containers and
+ * children of different types can be mixed in the same tree.
+ *
+ * The tree is walked without recursion, so deep trees do not use more
+ * stack. Every object is visited at most once: this makes the walk safe
+ * on trees with cycles, where @containerable itself is never emitted.
+ * The children of a container are collected when the walk reaches it,
+ * so the handlers can freely change the tree.
+ *
+ * As for g_containerable_propagate_valist(), @var_args is collected only
+ * once and the return value of the last emission is stored in the return
+ * location.
+ **/
+void
+g_containerable_propagate_deep_valist (GContainerable *containerable,
+                                       GTraverseType   order,
+                                       guint           signal_id,
+                                       GQuark          detail,
+                                       va_list         var_args)
+{
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (order == G_PRE_ORDER || order == G_POST_ORDER);
+
+  propagate_valist (containerable, TRUE, order,
+		    signal_id, detail, var_args);
+}
+
+/**
+ * g_containerable_propagate_deepv:
+ * @containerable: a #GContainerable
+ * @order: %G_PRE_ORDER or %G_POST_ORDER
+ * @signal_id: the signal id
+ * @detail: the detail
+ * @params: an array of the parameters to be passed to the signal, without
+ *          the instance, or %NULL if the signal has no parameters
+ * @return_value: location to store the return value or %NULL
+ *
+ * The same as g_containerable_propagate_deep_valist(), but taking the
+ * parameters as a #GValue array as described in
+ * g_containerable_propagatev().
+ **/
+void
+g_containerable_propagate_deepv (GContainerable *containerable,
+                                 GTraverseType   order,
+                                 guint           signal_id,
+                                 GQuark          detail,
+                                 const GValue   *params,
+                                 GValue         *return_value)
+{
+  g_return_if_fail (G_IS_CONTAINERABLE_CACHED (containerable));
+  g_return_if_fail (order == G_PRE_ORDER || order == G_POST_ORDER);
+
+  propagate_values (containerable, TRUE, order,
+		    signal_id, detail, params, return_value);
+}
+
+
+/**
+ * g_containerable_dispose_async:
+ * @containerable: a #GContainerable
+ * @context: the #GMainContext to use or %NULL for the default one
+ * @chunk_size: maximum number of objects to release per iteration
+ * @progress: function called after every chunk or %NULL
+ * @user_data: data to pass to @progress and @notify
+ * @notify: function to call on @user_data when the job is done or %NULL
+ *
+ * Detaches all the children of @containerable immediately, emitting the
+ * usual #GContainerable::remove and #GChildable::parent-set signals, and
+ * releases them and their whole subtrees incrementally from an idle
+ * source attached to @context.
+ *
+ * Every iteration of the idle source drops at most @chunk_size references.
+ * The containers destroyed by an iteration detach their own children,
+ * that are appended to the same job, so the time spent in an iteration
+ * depends only on @chunk_size and on the number of direct children of the
+ * destroyed containers, never on the size of the tree.
+ *
+ * After every iteration @progress is called with the number of objects
+ * released so far and the number of objects still pending: the job is
+ * completed when the latter is 0. Then @notify is called. Removing the
+ * source before completion releases all the pending objects at once.
+ *
+ * @containerable itself is not touched: it is left empty and can be
+ * reused or released as usual.
+ *
+ * Returns: the id of the idle source.
+ **/
+guint
+g_containerable_dispose_async (GContainerable             *containerable,
+			       GMainContext               *context,
+			       guint                       chunk_size,
+			       GContainerableProgressFunc  progress,
+			       gpointer                    user_data,
+			       GDestroyNotify              notify)
+{
+  DisposeJob *job;
+  GQueue     *previous;
+  GSource    *source;
+  guint       id;
+
+  g_return_val_if_fail (G_IS_CONTAINERABLE_CACHED (containerable), 0);
+  g_return_val_if_fail (chunk_size > 0, 0);
+
+  job = g_new0 (DisposeJob, 1);
+  g_queue_init (&job->worklist);
+  job->chunk_size = chunk_size;
+  job->progress = progress;
+  job->user_data = user_data;
+  job->notify = notify;
+
+  previous = g_private_get (&dispose_worklist);
+  g_private_set (&dispose_worklist, &job->worklist);
+
+  G_CONTAINERABLE_PEEK_IFACE (containerable)->foreach (containerable,
+						      (GFunc) dispose_child,
+						      containerable);
+
+  g_private_set (&dispose_worklist, previous);
+
+  source = g_idle_source_new ();
+  g_source_set_callback (source, (GSourceFunc) dispose_chunk,
+			 job, (GDestroyNotify) dispose_job_free);
+  id = g_source_attach (source, context);
+  g_source_unref (source);
+
+  return id;
 }
 
 /**
@@ -459,34 +2319,54 @@ g_containerable_propagate_valist (GContainerable *containerable,
  * g_containerable_dispose() automatically chain up the dispose method of the
  * parent class of the type in the @object hierarchy which implements
  * #GContainerable.
+ *
+ * The children are removed, emitting the usual #GContainerable::remove
+ * and #GChildable::parent-set signals, but they are released only by the
+ * outermost g_containerable_dispose() call of the current thread: the
+ * children disposed in the meantime append their own children to the
+ * same worklist. The stack usage is then constant, regardless of the
+ * depth of the tree being destroyed. As a consequence, a child is
+ * destroyed after the container it was inside.
  **/
 void
 g_containerable_dispose (GObject *object)
 {
-  GContainerable *containerable;
-  GSList         *children;
-  GChildable     *child;
-  GType           instance_type;
-  GObjectClass   *parent_class;
- 
-  if (G_CONTAINERABLE_IS_DISPOSING (object))
-    return;
+  GContainerable      *containerable;
+  GContainerableIface *containerable_iface;
+  GType                instance_type;
+  GObjectClass        *parent_class;
+  GQueue               worklist;
+  GObject             *child;
 
-  G_CONTAINERABLE_SET_DISPOSING (object);
-      
   containerable = (GContainerable *) object;
-  children = G_CONTAINERABLE_GET_IFACE (object)->get_children (containerable);
+  containerable_iface = G_CONTAINERABLE_PEEK_IFACE (containerable);
+
+  if (G_CONTAINERABLE_FLAGS (containerable_iface, containerable) & G_FLAG_DISPOSING)
+    return;
+
+  G_CONTAINERABLE_FLAGS (containerable_iface, containerable) |= G_FLAG_DISPOSING;
+
   instance_type = G_TYPE_INSTANCE_WHICH_IMPLEMENTS (object, G_TYPE_CONTAINERABLE);
   parent_class = g_type_class_peek (g_type_parent (instance_type));
 
-  while (children)
+  if (g_private_get (&dispose_worklist) != NULL)
     {
-      child = (GChildable *) children->data;
+      /* Nested dispose: the children are released by the outermost one */
+      containerable_iface->foreach (containerable,
+				    (GFunc) dispose_child, containerable);
+    }
+  else
+    {
+      g_queue_init (&worklist);
+      g_private_set (&dispose_worklist, &worklist);
 
-      if (child)
-        g_signal_emit (containerable, signals[REMOVE], 0, child);
+      containerable_iface->foreach (containerable,
+				    (GFunc) dispose_child, containerable);
 
-      children = g_slist_delete_link (children, children);
+      while ((child = g_queue_pop_head (&worklist)) != NULL)
+	g_object_unref (child);
+
+      g_private_set (&dispose_worklist, NULL);
     }
 
   parent_class->dispose (object);
@@ -34,6 +34,16 @@ G_BEGIN_DECLS
 /* Dummy typedef GContainerable forward declared in gchildable.h */
 typedef struct _GContainerableIface  GContainerableIface;
 
+typedef void (*GContainerableProgressFunc)	(guint		 n_disposed,
+						 guint		 n_pending,
+						 gpointer	 user_data);
+
+typedef enum
+{
+  G_CONTAINERABLE_EMIT_EACH,
+  G_CONTAINERABLE_EMIT_BATCH
+} GContainerableEmission;
+
 struct _GContainerableIface
 {
   GTypeInterface base_iface;
@@ -46,19 +56,75 @@ struct _GContainerableIface
 						 GChildable	*childable);
   gboolean	(*remove)			(GContainerable *containerable,
 						 GChildable	*childable);
+  void		(*foreach)			(GContainerable *containerable,
+						 GFunc		 func,
+						 gpointer	 user_data);
+  gboolean	(*add_many)			(GContainerable	*containerable,
+						 guint		 n_children,
+						 GChildable    **children);
+  gboolean	(*remove_many)			(GContainerable	*containerable,
+						 guint		 n_children,
+						 GChildable    **children);
+  guint *	(*get_flags)			(GContainerable *containerable);
+  GPtrArray *	(*get_children_snapshot)	(GContainerable *containerable);
+  gboolean	(*move_child)			(GContainerable *containerable,
+						 GChildable	*childable,
+						 GContainerable *old_parent);
+  guint		(*n_children)			(GContainerable *containerable);
+  gboolean	(*contains)			(GContainerable *containerable,
+						 GChildable	*childable);
+  GChildable *	(*get_nth)			(GContainerable *containerable,
+						 guint		 nth);
+  gboolean	(*add_indexed)			(GContainerable	*containerable,
+						 GChildable	*childable,
+						 guint		*position);
+  gboolean	(*remove_indexed)		(GContainerable *containerable,
+						 GChildable	*childable,
+						 guint		*position);
+  gint		(*get_position)			(GContainerable *containerable,
+						 GChildable	*childable);
 };
 
 
 GType		g_containerable_get_type	(void) G_GNUC_CONST;
 GSList *	g_containerable_get_children	(GContainerable	*containerable);
+GPtrArray *	g_containerable_get_children_snapshot
+						(GContainerable	*containerable);
+guint		g_containerable_n_children	(GContainerable	*containerable);
+gboolean	g_containerable_contains	(GContainerable	*containerable,
+						 GChildable	*childable);
+GChildable *	g_containerable_get_nth		(GContainerable	*containerable,
+						 guint		 nth);
 void		g_containerable_add		(GContainerable	*containerable,
 						 GChildable	*childable);
 void		g_containerable_remove		(GContainerable	*containerable,
 						 GChildable	*childable);
+void		g_containerable_add_unchecked	(GContainerable	*containerable,
+						 GChildable	*childable);
+void		g_containerable_remove_unchecked(GContainerable	*containerable,
+						 GChildable	*childable);
+void		g_containerable_add_many	(GContainerable	*containerable,
+						 guint		 n_children,
+						 GChildable    **children,
+						 GContainerableEmission emission);
+void		g_containerable_remove_many	(GContainerable	*containerable,
+						 guint		 n_children,
+						 GChildable    **children,
+						 GContainerableEmission emission);
+gboolean	g_containerable_move		(GContainerable	*containerable,
+						 GChildable	*childable);
+void		g_containerable_freeze_children_notify
+						(GContainerable	*containerable);
+void		g_containerable_thaw_children_notify
+						(GContainerable	*containerable);
 
 void		g_containerable_foreach		(GContainerable	*containerable,
 						 GCallback	 callback,
 						 gpointer	 user_data);
+void		g_containerable_foreach_unchecked
+						(GContainerable	*containerable,
+						 GCallback	 callback,
+						 gpointer	 user_data);
 void		g_containerable_propagate	(GContainerable *containerable,
 						 guint           signal_id,
 						 GQuark          detail,
@@ -71,6 +137,34 @@ void		g_containerable_propagate_valist(GContainerable *containerable,
 						 guint           signal_id,
 						 GQuark          detail,
 						 va_list         var_args);
+void		g_containerable_propagatev	(GContainerable *containerable,
+						 guint           signal_id,
+						 GQuark          detail,
+						 const GValue   *params,
+						 GValue         *return_value);
+void		g_containerable_propagate_deep	(GContainerable *containerable,
+						 GTraverseType   order,
+						 guint           signal_id,
+						 GQuark          detail,
+						 ...);
+void		g_containerable_propagate_deep_valist
+						(GContainerable *containerable,
+						 GTraverseType   order,
+						 guint           signal_id,
+						 GQuark          detail,
+						 va_list         var_args);
+void		g_containerable_propagate_deepv	(GContainerable *containerable,
+						 GTraverseType   order,
+						 guint           signal_id,
+						 GQuark          detail,
+						 const GValue   *params,
+						 GValue         *return_value);
+guint		g_containerable_dispose_async	(GContainerable *containerable,
+						 GMainContext   *context,
+						 guint           chunk_size,
+						 GContainerableProgressFunc progress,
+						 gpointer        user_data,
+						 GDestroyNotify  notify);
 void		g_containerable_dispose		(GObject	*object);
 
 
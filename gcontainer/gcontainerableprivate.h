@@ -0,0 +1,56 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Entry points of the GContainerable machinery reserved to the
+ * implementations shipped with the library.
+ */
+
+
+#ifndef __G_CONTAINERABLE_PRIVATE_H__
+#define __G_CONTAINERABLE_PRIVATE_H__
+
+#include "gcontainerable.h"
+
+
+G_BEGIN_DECLS
+
+
+/* Adds @childable at @position, storing its final index in @index */
+typedef gboolean (*GContainerableInsertFunc)	(GContainerable	*containerable,
+						 GChildable	*childable,
+						 gint		 position,
+						 guint		*index);
+
+
+void	_g_containerable_insert			(GContainerable	*containerable,
+						 GChildable	*childable,
+						 GContainerableInsertFunc insert,
+						 gint		 position);
+void	_g_containerable_children_changed	(GContainerable	*containerable,
+						 guint		 position,
+						 guint		 removed,
+						 guint		 added);
+gboolean _g_containerable_tracks_children	(GContainerable	*containerable);
+
+
+G_END_DECLS
+
+
+#endif /* __G_CONTAINERABLE_PRIVATE_H__ */
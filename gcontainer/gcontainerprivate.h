@@ -21,13 +21,20 @@
 #ifndef __G_CONTAINER_PRIVATE_H__
 #define __G_CONTAINER_PRIVATE_H__
 
+#include "gsequencewalk.h"
+
 
 G_BEGIN_DECLS
 
 
 struct _GContainerPrivate
 {
-  GSList		*children;
+  GSequence		*children;
+  GHashTable		*iters;
+  gboolean		 thread_safe;
+  GRWLock		 lock;
+  GPtrArray		*snapshot;
+  GSequenceWalk		*walks;
 };
 
 
@@ -0,0 +1,126 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#include "gifacecache.h"
+
+
+/* A derived class shares the interface vtable of its parent, so the
+ * vtable alone does not tell which instance type it was looked up for.
+ * Every instance type gets its own immutable entry, published with a
+ * compare-and-exchange in an open addressing table: the slots go only
+ * from %NULL to an entry, so readers need neither locks nor writes.
+ * Entries are never removed: only static types, that are never
+ * unregistered, are cached. When the table is full the lookup is
+ * simply not cached. */
+
+typedef struct _IfaceEntry IfaceEntry;
+
+struct _IfaceEntry
+{
+  GType		 instance_type;
+  gpointer	 iface;
+};
+
+
+static void	add_entry	(GIfaceCache	*cache,
+				 guint		 hash,
+				 GType		 instance_type,
+				 gpointer	 iface);
+
+
+GIfaceCache	_g_childable_iface_cache = { { NULL, } };
+GIfaceCache	_g_containerable_iface_cache = { { NULL, } };
+
+
+/* GType values of derived types are aligned pointers: the low bits
+ * are dropped and the others mixed with a multiplicative hash */
+#define HASH_TYPE(type)	((guint) (((gsize) (type) >> 3) * 2654435761u) % G_IFACE_CACHE_SIZE)
+
+
+gpointer
+_g_iface_cache_peek (GIfaceCache   *cache,
+		     gconstpointer  instance,
+		     GType          iface_type)
+{
+  const GTypeInstance *type_instance;
+  IfaceEntry          *entry;
+  GType                instance_type;
+  gpointer             iface;
+  guint                hash, n;
+
+  type_instance = instance;
+
+  if (type_instance == NULL || type_instance->g_class == NULL)
+    return NULL;
+
+  instance_type = G_TYPE_FROM_INSTANCE (type_instance);
+  hash = HASH_TYPE (instance_type);
+
+  for (n = 0; n < G_IFACE_CACHE_SIZE; ++ n)
+    {
+      entry = g_atomic_pointer_get (&cache->slots[(hash + n) % G_IFACE_CACHE_SIZE]);
+
+      if (entry == NULL)
+	break;
+
+      if (G_LIKELY (entry->instance_type == instance_type))
+	return entry->iface;
+    }
+
+  iface = g_type_interface_peek (type_instance->g_class, iface_type);
+
+  /* The vtables of dynamic types are released when their plugin is
+   * unloaded, so only the static ones can be cached */
+  if (iface != NULL &&
+      g_type_get_plugin (instance_type) == NULL &&
+      g_type_interface_get_plugin (instance_type, iface_type) == NULL)
+    add_entry (cache, hash, instance_type, iface);
+
+  return iface;
+}
+
+static void
+add_entry (GIfaceCache *cache,
+	   guint        hash,
+	   GType        instance_type,
+	   gpointer     iface)
+{
+  IfaceEntry *entry, *other;
+  guint       n, slot;
+
+  entry = g_new (IfaceEntry, 1);
+  entry->instance_type = instance_type;
+  entry->iface = iface;
+
+  for (n = 0; n < G_IFACE_CACHE_SIZE; ++ n)
+    {
+      slot = (hash + n) % G_IFACE_CACHE_SIZE;
+
+      if (g_atomic_pointer_compare_and_exchange (&cache->slots[slot], NULL, entry))
+	return;
+
+      /* Another thread cached the same type in the meantime */
+      other = g_atomic_pointer_get (&cache->slots[slot]);
+      if (other->instance_type == instance_type)
+	break;
+    }
+
+  g_free (entry);
+}
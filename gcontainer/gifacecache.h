@@ -0,0 +1,70 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/*
+ * A cache of the interface vtables of GChildable and GContainerable.
+ * Looking up an interface with G_TYPE_INSTANCE_GET_INTERFACE or checking
+ * it with G_TYPE_CHECK_INSTANCE_TYPE goes through the type system every
+ * time, while on the hot paths the same few types are used over and over.
+ * The cache is a fixed table keyed by instance type: a lookup never locks
+ * and, once the types in use are cached, never writes shared memory.
+ *
+ * The G_*_PEEK_IFACE() macros return the vtable of @obj or %NULL if @obj
+ * is %NULL or does not implement the interface, so they can be used both
+ * as type check and as lookup.
+ */
+
+
+#ifndef __G_IFACE_CACHE_H__
+#define __G_IFACE_CACHE_H__
+
+#include <glib-object.h>
+
+
+G_BEGIN_DECLS
+
+#define G_CHILDABLE_PEEK_IFACE(obj) \
+  ((GChildableIface *) _g_iface_cache_peek (&_g_childable_iface_cache, (obj), G_TYPE_CHILDABLE))
+#define G_CONTAINERABLE_PEEK_IFACE(obj) \
+  ((GContainerableIface *) _g_iface_cache_peek (&_g_containerable_iface_cache, (obj), G_TYPE_CONTAINERABLE))
+#define G_IS_CHILDABLE_CACHED(obj)	(G_CHILDABLE_PEEK_IFACE (obj) != NULL)
+#define G_IS_CONTAINERABLE_CACHED(obj)	(G_CONTAINERABLE_PEEK_IFACE (obj) != NULL)
+
+#define G_IFACE_CACHE_SIZE	256
+
+typedef struct _GIfaceCache GIfaceCache;
+
+struct _GIfaceCache
+{
+  gpointer	 slots[G_IFACE_CACHE_SIZE];
+};
+
+
+extern GIfaceCache	_g_childable_iface_cache;
+extern GIfaceCache	_g_containerable_iface_cache;
+
+gpointer		_g_iface_cache_peek	(GIfaceCache	*cache,
+						 gconstpointer	 instance,
+						 GType		 iface_type);
+
+G_END_DECLS
+
+
+#endif /* __G_IFACE_CACHE_H__ */
@@ -0,0 +1,238 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#include "ginstancepool.h"
+#include <string.h>
+
+
+static void	collect_quark	(GQuark		 key_id,
+				 gpointer	 data,
+				 gpointer	 user_data);
+static void	reset_data	(GObject	*object);
+
+
+/**
+ * _g_instance_pool_acquire:
+ * @pool: a #GInstancePool
+ *
+ * Takes an instance out of @pool. The instance is given back with a
+ * floating reference, just like a newly created #GInitiallyUnowned.
+ *
+ * Returns: a recycled instance or %NULL if @pool is empty
+ **/
+GObject *
+_g_instance_pool_acquire (GInstancePool *pool)
+{
+  GObject *object;
+
+  g_mutex_lock (&pool->mutex);
+
+  if (pool->instances == NULL || pool->instances->len == 0)
+    {
+      g_mutex_unlock (&pool->mutex);
+      return NULL;
+    }
+
+  object = g_ptr_array_remove_index_fast (pool->instances,
+					  pool->instances->len - 1);
+  ++ pool->stats.n_reused;
+
+  g_mutex_unlock (&pool->mutex);
+
+  /* The reference held by the pool is passed to the caller */
+  g_object_force_floating (object);
+  return object;
+}
+
+/**
+ * _g_instance_pool_release:
+ * @pool: a #GInstancePool
+ * @object: a disposed #GObject, still holding its last reference
+ *
+ * Puts @object in @pool if there is room for it. This must be called by
+ * the dispose method of @object, after the object has been reset to its
+ * initial state.
+ *
+ * Signal handlers, weak references and weak pointers of @object are
+ * released here, as done by the dispose method of #GObject. Any data
+ * attached to @object, by the library or by the user, is released too,
+ * so a recycled instance is indistinguishable from a new one.
+ *
+ * @object is not pooled if it has been referenced again in the meantime,
+ * e.g. by a g_weak_ref_get() that won the race with the last unref.
+ *
+ * Returns: %TRUE if @object has been pooled, so it will not be finalized
+ **/
+gboolean
+_g_instance_pool_release (GInstancePool *pool,
+			  GObject       *object)
+{
+  GObjectClass *object_class;
+
+  /* Only the last unref can be intercepted: g_object_run_dispose()
+   * and resurrected objects are left alone */
+  if (g_atomic_int_get ((gint *) &object->ref_count) != 1)
+    return FALSE;
+
+  g_mutex_lock (&pool->mutex);
+
+  if (pool->limit == 0)
+    {
+      g_mutex_unlock (&pool->mutex);
+      return FALSE;
+    }
+
+  if (pool->instances != NULL && pool->instances->len >= pool->limit)
+    {
+      ++ pool->stats.n_dropped;
+      g_mutex_unlock (&pool->mutex);
+      return FALSE;
+    }
+
+  g_mutex_unlock (&pool->mutex);
+
+  object_class = g_type_class_peek (G_TYPE_OBJECT);
+  object_class->dispose (object);
+
+  /* After the GObject dispose no weak pointer can revive @object
+   * anymore, so a reference count still at 1 is now final */
+  if (g_atomic_int_get ((gint *) &object->ref_count) != 1)
+    return FALSE;
+
+  reset_data (object);
+
+  g_mutex_lock (&pool->mutex);
+
+  if (pool->instances == NULL)
+    pool->instances = g_ptr_array_new ();
+
+  g_ptr_array_add (pool->instances, g_object_ref (object));
+  ++ pool->stats.n_recycled;
+
+  g_mutex_unlock (&pool->mutex);
+
+  return TRUE;
+}
+
+/**
+ * _g_instance_pool_set_limit:
+ * @pool: a #GInstancePool
+ * @limit: the maximum number of retained instances
+ *
+ * Changes the limit of @pool, finalizing the instances exceeding it.
+ * A @limit of 0 disables @pool.
+ **/
+void
+_g_instance_pool_set_limit (GInstancePool *pool,
+			    guint          limit)
+{
+  GPtrArray *surplus;
+  guint      n;
+
+  surplus = NULL;
+
+  g_mutex_lock (&pool->mutex);
+
+  pool->limit = limit;
+
+  if (pool->instances != NULL && pool->instances->len > limit)
+    {
+      surplus = g_ptr_array_new ();
+
+      while (pool->instances->len > limit)
+	g_ptr_array_add (surplus,
+			 g_ptr_array_remove_index_fast (pool->instances,
+							pool->instances->len - 1));
+    }
+
+  g_mutex_unlock (&pool->mutex);
+
+  /* Finalize outside the lock: a finalizer could use the pool */
+  if (surplus != NULL)
+    {
+      for (n = 0; n < surplus->len; ++ n)
+	g_object_unref (g_ptr_array_index (surplus, n));
+
+      g_ptr_array_free (surplus, TRUE);
+    }
+}
+
+/**
+ * _g_instance_pool_get_stats:
+ * @pool: a #GInstancePool
+ * @stats: where to store the statistics
+ *
+ * Fills @stats with the current state of @pool.
+ **/
+void
+_g_instance_pool_get_stats (GInstancePool      *pool,
+			    GInstancePoolStats *stats)
+{
+  g_mutex_lock (&pool->mutex);
+
+  *stats = pool->stats;
+  stats->limit = pool->limit;
+  stats->n_pooled = pool->instances != NULL ? pool->instances->len : 0;
+
+  g_mutex_unlock (&pool->mutex);
+}
+
+
+/* GObject keeps its own state in the data list too, e.g. the notify
+ * queue frozen by g_object_unref() around dispose: only the data not
+ * owned by GObject, whose quarks are all prefixed by "GObject-", is
+ * released */
+
+static void
+collect_quark (GQuark   key_id,
+	       gpointer data,
+	       gpointer user_data)
+{
+  GArray **quarks = user_data;
+
+  if (strncmp (g_quark_to_string (key_id), "GObject-", 8) == 0)
+    return;
+
+  if (*quarks == NULL)
+    *quarks = g_array_new (FALSE, FALSE, sizeof (GQuark));
+
+  g_array_append_val (*quarks, key_id);
+}
+
+static void
+reset_data (GObject *object)
+{
+  GArray *quarks;
+  guint   n;
+
+  quarks = NULL;
+
+  /* The destroy notifiers could change the data list, so they are
+   * not called while walking it */
+  g_datalist_foreach (&object->qdata, collect_quark, &quarks);
+
+  if (quarks == NULL)
+    return;
+
+  for (n = 0; n < quarks->len; ++ n)
+    g_object_set_qdata (object, g_array_index (quarks, GQuark, n), NULL);
+
+  g_array_free (quarks, TRUE);
+}
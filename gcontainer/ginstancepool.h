@@ -0,0 +1,67 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/*
+ * A bounded pool of disposed instances, used by the constructors of
+ * GChild and GContainer to skip a full finalize and re-init cycle.
+ *
+ * An instance is released to the pool from its dispose method, while
+ * it is still holding the last reference: the pool takes a new one,
+ * so g_object_unref() sees the object resurrected and does not
+ * finalize it. Everything attached to the object by GObject, by the
+ * library or by the user is dropped before pooling it, while the
+ * constructors must reset the private state of their own type.
+ * The pool is disabled (limit 0) by default.
+ */
+
+
+#ifndef __G_INSTANCE_POOL_H__
+#define __G_INSTANCE_POOL_H__
+
+#include <gcontainer/gchild.h>
+
+
+G_BEGIN_DECLS
+
+#define G_INSTANCE_POOL_INIT	{ { 0, }, NULL, 0, { 0, } }
+
+typedef struct _GInstancePool GInstancePool;
+
+struct _GInstancePool
+{
+  GMutex		 mutex;
+  GPtrArray		*instances;
+  guint			 limit;
+  GInstancePoolStats	 stats;
+};
+
+
+GObject *	_g_instance_pool_acquire	(GInstancePool	*pool);
+gboolean	_g_instance_pool_release	(GInstancePool	*pool,
+						 GObject	*object);
+void		_g_instance_pool_set_limit	(GInstancePool	*pool,
+						 guint		 limit);
+void		_g_instance_pool_get_stats	(GInstancePool	*pool,
+						 GInstancePoolStats *stats);
+
+G_END_DECLS
+
+
+#endif /* __G_INSTANCE_POOL_H__ */
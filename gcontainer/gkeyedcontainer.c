@@ -0,0 +1,530 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:gkeyedcontainer
+ * @short_description: A container indexed by key
+ *
+ * A #GKeyedContainer is a #GContainerable whose children are indexed by
+ * a string key, so g_keyed_container_lookup() finds a child in O(1)
+ * instead of walking all the children. The key of a child is computed
+ * once, when it is added, either by reading a string property of the
+ * child (see g_keyed_container_new()) or by calling a custom function
+ * (see g_keyed_container_new_with_func()).
+ *
+ * Keys are unique: adding a child whose key is already used by another
+ * child, or a child without a key, is refused with a warning. The index
+ * follows every addition and removal, so also a child reparented with
+ * g_childable_reparent() or g_containerable_move() is looked up in its
+ * new container only. The key of a child must not change while the
+ * child is inside a #GKeyedContainer.
+ *
+ * As in #GContainer, the children are kept in a #GSequence in the order
+ * they were added, so g_containerable_get_nth() is O(log n).
+ **/
+
+/**
+ * GKeyedContainer:
+ *
+ * All the fields in the GKeyedContainer structure are private and should
+ * never be accessed directly.
+ **/
+
+#include "gkeyedcontainer.h"
+#include "gkeyedcontainerprivate.h"
+#include "gchildprivate.h"
+#include "gcontainerintl.h"
+
+
+enum
+{
+  PROP_0,
+  PROP_CHILD,
+  PROP_KEY_PROPERTY
+};
+
+
+static void	containerable_init	(GContainerableIface *iface);
+static void	finalize		(GObject	*object);
+static void	get_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         GValue		*value,
+                                         GParamSpec	*pspec);
+static void     set_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         const GValue	*value,
+                                         GParamSpec	*pspec);
+static GSList * get_children		(GContainerable	*containerable);
+static gboolean add			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gboolean remove			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+                                         GFunc		 func,
+                                         gpointer	 user_data);
+static guint *	get_flags		(GContainerable	*containerable);
+static guint	n_children		(GContainerable	*containerable);
+static gboolean contains		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static GChildable *
+		get_nth			(GContainerable	*containerable,
+                                         guint		 nth);
+static gboolean add_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gboolean remove_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gint	get_position		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gchar *	get_key			(GKeyedContainer *keyed_container,
+                                         GChildable	*childable);
+
+
+G_DEFINE_TYPE_EXTENDED (GKeyedContainer, g_keyed_container, G_TYPE_CHILD, 0, 
+                        G_IMPLEMENT_INTERFACE (G_TYPE_CONTAINERABLE, 
+                                               containerable_init));
+
+
+static void
+containerable_init (GContainerableIface *iface)
+{
+  iface->get_children = get_children;
+  iface->add = add;
+  iface->remove = remove;
+  iface->foreach = foreach;
+  iface->get_flags = get_flags;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
+  iface->add_indexed = add_indexed;
+  iface->remove_indexed = remove_indexed;
+  iface->get_position = get_position;
+}
+
+static void
+g_keyed_container_class_init (GKeyedContainerClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = (GObjectClass *) klass;
+
+  g_type_class_add_private (klass, sizeof (GKeyedContainerPrivate));
+
+  gobject_class->get_property = get_property;
+  gobject_class->set_property = set_property;
+  gobject_class->dispose = g_containerable_dispose;
+  gobject_class->finalize = finalize;
+
+  g_object_class_override_property (gobject_class, PROP_CHILD, "child");
+
+  /**
+   * GKeyedContainer:key-property:
+   *
+   * The name of the string property of the children used as key.
+   * Can be set only at construction time.
+   **/
+  g_object_class_install_property (gobject_class, PROP_KEY_PROPERTY,
+				   g_param_spec_string ("key-property",
+							P_("Key property"),
+							P_("The property of the children used as key"),
+							NULL,
+							G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+}
+
+static void
+g_keyed_container_init (GKeyedContainer *keyed_container)
+{
+  keyed_container->priv = G_TYPE_INSTANCE_GET_PRIVATE (keyed_container,
+						       G_TYPE_KEYED_CONTAINER,
+						       GKeyedContainerPrivate);
+  keyed_container->priv->nodes = g_sequence_new (NULL);
+  keyed_container->priv->iters = g_hash_table_new (NULL, NULL);
+  keyed_container->priv->walks = NULL;
+  keyed_container->priv->index = g_hash_table_new (g_str_hash, g_str_equal);
+  keyed_container->priv->key_property = NULL;
+  keyed_container->priv->key_func = NULL;
+  keyed_container->priv->key_data = NULL;
+  keyed_container->priv->key_notify = NULL;
+}
+
+static void
+finalize (GObject *object)
+{
+  GKeyedContainer *keyed_container;
+  GSequenceIter   *iter;
+  GKeyedNode      *node;
+
+  keyed_container = (GKeyedContainer *) object;
+
+  /* Disposing the container has yet removed all the children */
+  for (iter = g_sequence_get_begin_iter (keyed_container->priv->nodes);
+       !g_sequence_iter_is_end (iter); iter = g_sequence_iter_next (iter))
+    {
+      node = g_sequence_get (iter);
+      g_free (node->key);
+      g_slice_free (GKeyedNode, node);
+    }
+
+  g_sequence_free (keyed_container->priv->nodes);
+  g_hash_table_destroy (keyed_container->priv->iters);
+  g_hash_table_destroy (keyed_container->priv->index);
+  g_free (keyed_container->priv->key_property);
+
+  if (keyed_container->priv->key_notify != NULL)
+    keyed_container->priv->key_notify (keyed_container->priv->key_data);
+
+  G_OBJECT_CLASS (g_keyed_container_parent_class)->finalize (object);
+}
+
+static void
+get_property (GObject    *object,
+	      guint       prop_id,
+	      GValue     *value,
+	      GParamSpec *pspec)
+{
+  GKeyedContainer *keyed_container = (GKeyedContainer *) object;
+
+  switch (prop_id)
+    {
+    case PROP_KEY_PROPERTY:
+      g_value_set_string (value, keyed_container->priv->key_property);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+set_property (GObject      *object,
+	      guint         prop_id,
+	      const GValue *value,
+	      GParamSpec   *pspec)
+{
+  GContainerable *containerable = (GContainerable *) object;
+
+  switch (prop_id)
+    {
+    case PROP_CHILD:
+      g_containerable_add (containerable, g_value_get_object (value));
+      break;
+    case PROP_KEY_PROPERTY:
+      ((GKeyedContainer *) object)->priv->key_property = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+
+static GSList *
+get_children (GContainerable *containerable)
+{
+  GKeyedContainer *keyed_container;
+  GSList          *children;
+  GSequenceIter   *iter, *begin;
+
+  keyed_container = (GKeyedContainer *) containerable;
+  children = NULL;
+  iter = g_sequence_get_end_iter (keyed_container->priv->nodes);
+  begin = g_sequence_get_begin_iter (keyed_container->priv->nodes);
+
+  /* Walking backward allows to build the list by prepending */
+  while (iter != begin)
+    {
+      iter = g_sequence_iter_prev (iter);
+      children = g_slist_prepend (children,
+				  ((GKeyedNode *) g_sequence_get (iter))->childable);
+    }
+
+  return children;
+}
+
+static gboolean
+add (GContainerable *containerable,
+     GChildable     *childable)
+{
+  return add_indexed (containerable, childable, NULL);
+}
+
+static gboolean
+remove (GContainerable *containerable,
+	GChildable     *childable)
+{
+  return remove_indexed (containerable, childable, NULL);
+}
+
+/* A %NULL @position is accepted for the plain add() and remove() */
+
+static gboolean
+add_indexed (GContainerable *containerable,
+	     GChildable     *childable,
+	     guint          *position)
+{
+  GKeyedContainer *keyed_container;
+  GKeyedNode      *node;
+  GSequenceIter   *iter;
+  gchar           *key;
+
+  keyed_container = (GKeyedContainer *) containerable;
+  key = get_key (keyed_container, childable);
+
+  if (key == NULL)
+    {
+      g_warning ("Attempting to add an object with type %s to a %s, "
+		 "but the object has no key",
+		 g_type_name (G_OBJECT_TYPE (childable)),
+		 g_type_name (G_OBJECT_TYPE (keyed_container)));
+      return FALSE;
+    }
+
+  iter = g_hash_table_lookup (keyed_container->priv->index, key);
+
+  if (iter != NULL)
+    {
+      g_warning ("Attempting to add an object with type %s to a %s, "
+		 "but the key `%s' is already used by an object of type %s",
+		 g_type_name (G_OBJECT_TYPE (childable)),
+		 g_type_name (G_OBJECT_TYPE (keyed_container)),
+		 key,
+		 g_type_name (G_OBJECT_TYPE (((GKeyedNode *) g_sequence_get (iter))->childable)));
+      g_free (key);
+      return FALSE;
+    }
+
+  node = g_slice_new (GKeyedNode);
+  node->childable = childable;
+  node->key = key;
+
+  iter = g_sequence_append (keyed_container->priv->nodes, node);
+  g_hash_table_insert (keyed_container->priv->iters, childable, iter);
+  g_hash_table_insert (keyed_container->priv->index, key, iter);
+
+  if (position != NULL)
+    *position = g_sequence_iter_get_position (iter);
+
+  return TRUE;
+}
+
+static gboolean
+remove_indexed (GContainerable *containerable,
+		GChildable     *childable,
+		guint          *position)
+{
+  GKeyedContainer *keyed_container;
+  GKeyedNode      *node;
+  GSequenceIter   *iter;
+
+  keyed_container = (GKeyedContainer *) containerable;
+  iter = g_hash_table_lookup (keyed_container->priv->iters, childable);
+
+  if (iter == NULL)
+    return FALSE;
+
+  if (position != NULL)
+    *position = g_sequence_iter_get_position (iter);
+
+  /* The key stored in the node is used, because the key of
+   * the child could be not computable anymore */
+  node = g_sequence_get (iter);
+  g_hash_table_remove (keyed_container->priv->index, node->key);
+  g_hash_table_remove (keyed_container->priv->iters, childable);
+  _g_sequence_walk_skip (keyed_container->priv->walks, iter);
+  g_sequence_remove (iter);
+
+  g_free (node->key);
+  g_slice_free (GKeyedNode, node);
+
+  return TRUE;
+}
+
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GKeyedContainer *keyed_container;
+  GSequenceWalk    walk;
+  GSequenceIter   *iter;
+
+  keyed_container = (GKeyedContainer *) containerable;
+
+  /* As in GContainer, the removals move the walk past the freed nodes */
+  _g_sequence_walk_begin (&walk, &keyed_container->priv->walks,
+			  keyed_container->priv->nodes);
+
+  while ((iter = _g_sequence_walk_next (&walk)) != NULL)
+    func (((GKeyedNode *) g_sequence_get (iter))->childable, user_data);
+
+  _g_sequence_walk_end (&walk, &keyed_container->priv->walks);
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+static guint
+n_children (GContainerable *containerable)
+{
+  GKeyedContainer *keyed_container = (GKeyedContainer *) containerable;
+
+  return g_sequence_get_length (keyed_container->priv->nodes);
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  GKeyedContainer *keyed_container = (GKeyedContainer *) containerable;
+
+  return g_hash_table_lookup (keyed_container->priv->iters, childable) != NULL;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  GKeyedContainer *keyed_container;
+  GKeyedNode      *node;
+
+  keyed_container = (GKeyedContainer *) containerable;
+
+  if (nth >= (guint) g_sequence_get_length (keyed_container->priv->nodes))
+    return NULL;
+
+  node = g_sequence_get (g_sequence_get_iter_at_pos (keyed_container->priv->nodes, nth));
+  return node->childable;
+}
+
+static gint
+get_position (GContainerable *containerable,
+	      GChildable     *childable)
+{
+  GKeyedContainer *keyed_container;
+  GSequenceIter   *iter;
+
+  keyed_container = (GKeyedContainer *) containerable;
+  iter = g_hash_table_lookup (keyed_container->priv->iters, childable);
+
+  return iter != NULL ? g_sequence_iter_get_position (iter) : -1;
+}
+
+static gchar *
+get_key (GKeyedContainer *keyed_container,
+	 GChildable      *childable)
+{
+  GParamSpec *pspec;
+  gchar      *key;
+
+  if (keyed_container->priv->key_func != NULL)
+    return keyed_container->priv->key_func (childable,
+					    keyed_container->priv->key_data);
+
+  if (keyed_container->priv->key_property == NULL)
+    return NULL;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (childable),
+					keyed_container->priv->key_property);
+
+  if (pspec == NULL || pspec->value_type != G_TYPE_STRING ||
+      (pspec->flags & G_PARAM_READABLE) == 0)
+    return NULL;
+
+  g_object_get (childable, keyed_container->priv->key_property, &key, NULL);
+  return key;
+}
+
+
+/**
+ * g_keyed_container_new:
+ * @key_property: the name of a string property of the children
+ *
+ * Creates a new container that indexes its children by the value of
+ * their @key_property property. Children without such property, or
+ * with the property set to %NULL, cannot be added.
+ *
+ * Return value: a #GKeyedContainer instance
+ **/
+GObject *
+g_keyed_container_new (const gchar *key_property)
+{
+  g_return_val_if_fail (key_property != NULL, NULL);
+
+  return g_object_new (G_TYPE_KEYED_CONTAINER,
+		       "key-property", key_property,
+		       NULL);
+}
+
+/**
+ * g_keyed_container_new_with_func:
+ * @key_func: the function computing the key of a child
+ * @user_data: data to pass to @key_func
+ * @notify: function to call on @user_data when the container is
+ *          finalized, or %NULL
+ *
+ * Creates a new container that indexes its children by the key
+ * returned by @key_func. Children for which @key_func returns %NULL
+ * cannot be added.
+ *
+ * Return value: a #GKeyedContainer instance
+ **/
+GObject *
+g_keyed_container_new_with_func (GKeyedContainerKeyFunc key_func,
+				 gpointer               user_data,
+				 GDestroyNotify         notify)
+{
+  GKeyedContainer *keyed_container;
+
+  g_return_val_if_fail (key_func != NULL, NULL);
+
+  keyed_container = g_object_new (G_TYPE_KEYED_CONTAINER, NULL);
+  keyed_container->priv->key_func = key_func;
+  keyed_container->priv->key_data = user_data;
+  keyed_container->priv->key_notify = notify;
+
+  return (GObject *) keyed_container;
+}
+
+/**
+ * g_keyed_container_lookup:
+ * @keyed_container: a #GKeyedContainer
+ * @key: the key to look for
+ *
+ * Looks up the child of @keyed_container whose key is @key.
+ *
+ * Returns: the child with @key or %NULL if not found
+ **/
+GChildable *
+g_keyed_container_lookup (GKeyedContainer *keyed_container,
+			  const gchar     *key)
+{
+  GSequenceIter *iter;
+
+  g_return_val_if_fail (G_IS_KEYED_CONTAINER (keyed_container), NULL);
+  g_return_val_if_fail (key != NULL, NULL);
+
+  iter = g_hash_table_lookup (keyed_container->priv->index, key);
+
+  return iter != NULL ? ((GKeyedNode *) g_sequence_get (iter))->childable : NULL;
+}
@@ -0,0 +1,80 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef __G_KEYED_CONTAINER_H__
+#define __G_KEYED_CONTAINER_H__
+
+#include <gcontainer/gchild.h>
+
+
+G_BEGIN_DECLS
+
+
+#define G_TYPE_KEYED_CONTAINER             (g_keyed_container_get_type ())
+#define G_KEYED_CONTAINER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), G_TYPE_KEYED_CONTAINER, GKeyedContainer))
+#define G_KEYED_CONTAINER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), G_TYPE_KEYED_CONTAINER, GKeyedContainerClass))
+#define G_IS_KEYED_CONTAINER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), G_TYPE_KEYED_CONTAINER))
+#define G_IS_KEYED_CONTAINER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), G_TYPE_KEYED_CONTAINER))
+#define G_KEYED_CONTAINER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), G_TYPE_KEYED_CONTAINER, GKeyedContainerClass))
+
+
+typedef struct _GKeyedContainer	       GKeyedContainer;
+typedef struct _GKeyedContainerClass   GKeyedContainerClass;
+typedef struct _GKeyedContainerPrivate GKeyedContainerPrivate;
+
+/**
+ * GKeyedContainerKeyFunc:
+ * @childable: a #GObject implementing #GChildable
+ * @user_data: user data passed to g_keyed_container_new_with_func()
+ *
+ * Computes the key of @childable.
+ *
+ * Returns: a newly allocated string or %NULL if @childable has no key
+ **/
+typedef gchar *	(*GKeyedContainerKeyFunc)	(GChildable	*childable,
+						 gpointer	 user_data);
+
+struct _GKeyedContainer
+{
+  GChild			 child;
+
+  /*< private >*/
+  GKeyedContainerPrivate	*priv;
+};
+
+struct _GKeyedContainerClass
+{
+  GChildClass			 parent_class;
+};
+
+
+GType		g_keyed_container_get_type	(void) G_GNUC_CONST;
+GObject *	g_keyed_container_new		(const gchar	*key_property);
+GObject *	g_keyed_container_new_with_func	(GKeyedContainerKeyFunc key_func,
+						 gpointer	 user_data,
+						 GDestroyNotify	 notify);
+GChildable *	g_keyed_container_lookup	(GKeyedContainer *keyed_container,
+						 const gchar	*key);
+
+
+G_END_DECLS
+
+
+#endif /* __G_KEYED_CONTAINER_H__ */
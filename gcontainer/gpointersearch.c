@@ -0,0 +1,229 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#include "gpointersearch.h"
+
+/* The vector kernels are built with the target attribute, so the rest
+ * of the library does not need any special compiler flag */
+#if (defined (__x86_64__) || defined (__i386__)) && \
+    (defined (__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define G_POINTER_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+
+typedef gint (*SearchFunc) (gconstpointer *pointers,
+			    guint          n_pointers,
+			    gconstpointer  needle);
+
+
+static gint	search_scalar	(gconstpointer	*pointers,
+				 guint		 n_pointers,
+				 gconstpointer	 needle);
+#ifdef G_POINTER_SEARCH_X86
+static gint	search_sse2	(gconstpointer	*pointers,
+				 guint		 n_pointers,
+				 gconstpointer	 needle);
+static gint	search_avx2	(gconstpointer	*pointers,
+				 guint		 n_pointers,
+				 gconstpointer	 needle);
+#endif
+static void	pick_search	(void);
+
+
+static SearchFunc   search = NULL;
+static const gchar *search_impl = NULL;
+
+
+static gint
+search_scalar (gconstpointer *pointers,
+	       guint          n_pointers,
+	       gconstpointer  needle)
+{
+  guint n;
+
+  for (n = 0; n < n_pointers; ++ n)
+    if (pointers[n] == needle)
+      return n;
+
+  return -1;
+}
+
+#ifdef G_POINTER_SEARCH_X86
+
+/* SSE2 has no 64 bit comparison: two 32 bit lanes are compared and a
+ * pointer matches when both its halves are equal */
+
+__attribute__ ((target ("sse2")))
+static gint
+search_sse2 (gconstpointer *pointers,
+	     guint          n_pointers,
+	     gconstpointer  needle)
+{
+  const guint per_vector = sizeof (__m128i) / sizeof (gpointer);
+  __m128i     key, lo, hi;
+  guint       n, mask;
+
+#if GLIB_SIZEOF_VOID_P == 8
+  key = _mm_set1_epi64x ((gint64) (gintptr) needle);
+#else
+  key = _mm_set1_epi32 ((gint32) (gintptr) needle);
+#endif
+
+  /* Two vectors per iteration, so the loads overlap the comparisons */
+  for (n = 0; n + 2 * per_vector <= n_pointers; n += 2 * per_vector)
+    {
+      lo = _mm_cmpeq_epi32 (key, _mm_loadu_si128 ((const __m128i *) (pointers + n)));
+      hi = _mm_cmpeq_epi32 (key, _mm_loadu_si128 ((const __m128i *) (pointers + n + per_vector)));
+
+#if GLIB_SIZEOF_VOID_P == 8
+      lo = _mm_and_si128 (lo, _mm_shuffle_epi32 (lo, _MM_SHUFFLE (2, 3, 0, 1)));
+      hi = _mm_and_si128 (hi, _mm_shuffle_epi32 (hi, _MM_SHUFFLE (2, 3, 0, 1)));
+      mask = _mm_movemask_pd (_mm_castsi128_pd (lo)) |
+	     _mm_movemask_pd (_mm_castsi128_pd (hi)) << 2;
+#else
+      mask = _mm_movemask_ps (_mm_castsi128_ps (lo)) |
+	     _mm_movemask_ps (_mm_castsi128_ps (hi)) << 4;
+#endif
+
+      if (mask != 0)
+	return n + g_bit_nth_lsf (mask, -1);
+    }
+
+  for (; n < n_pointers; ++ n)
+    if (pointers[n] == needle)
+      return n;
+
+  return -1;
+}
+
+__attribute__ ((target ("avx2")))
+static gint
+search_avx2 (gconstpointer *pointers,
+	     guint          n_pointers,
+	     gconstpointer  needle)
+{
+  const guint per_vector = sizeof (__m256i) / sizeof (gpointer);
+  __m256i     key, lo, hi;
+  guint       n, mask;
+
+#if GLIB_SIZEOF_VOID_P == 8
+  key = _mm256_set1_epi64x ((gint64) (gintptr) needle);
+#else
+  key = _mm256_set1_epi32 ((gint32) (gintptr) needle);
+#endif
+
+  for (n = 0; n + 2 * per_vector <= n_pointers; n += 2 * per_vector)
+    {
+#if GLIB_SIZEOF_VOID_P == 8
+      lo = _mm256_cmpeq_epi64 (key, _mm256_loadu_si256 ((const __m256i *) (pointers + n)));
+      hi = _mm256_cmpeq_epi64 (key, _mm256_loadu_si256 ((const __m256i *) (pointers + n + per_vector)));
+      mask = _mm256_movemask_pd (_mm256_castsi256_pd (lo)) |
+	     _mm256_movemask_pd (_mm256_castsi256_pd (hi)) << 4;
+#else
+      lo = _mm256_cmpeq_epi32 (key, _mm256_loadu_si256 ((const __m256i *) (pointers + n)));
+      hi = _mm256_cmpeq_epi32 (key, _mm256_loadu_si256 ((const __m256i *) (pointers + n + per_vector)));
+      mask = _mm256_movemask_ps (_mm256_castsi256_ps (lo)) |
+	     _mm256_movemask_ps (_mm256_castsi256_ps (hi)) << 8;
+#endif
+
+      if (mask != 0)
+	return n + g_bit_nth_lsf (mask, -1);
+    }
+
+  for (; n < n_pointers; ++ n)
+    if (pointers[n] == needle)
+      return n;
+
+  return -1;
+}
+
+#endif /* G_POINTER_SEARCH_X86 */
+
+/* Selects the implementation the first time it is called. search and
+ * search_impl are written once, inside g_once_init_enter() and
+ * g_once_init_leave(), so any thread getting past them reads both */
+static void
+pick_search (void)
+{
+  static gsize picked = 0;
+
+  if (G_LIKELY (!g_once_init_enter (&picked)))
+    return;
+
+#ifdef G_POINTER_SEARCH_X86
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("avx2"))
+    {
+      search_impl = "avx2";
+      search = search_avx2;
+    }
+  else if (__builtin_cpu_supports ("sse2"))
+    {
+      search_impl = "sse2";
+      search = search_sse2;
+    }
+  else
+#endif
+    {
+      search_impl = "scalar";
+      search = search_scalar;
+    }
+
+  g_once_init_leave (&picked, 1);
+}
+
+
+/**
+ * _g_pointer_search:
+ * @pointers: an array of pointers
+ * @n_pointers: number of elements in @pointers
+ * @needle: the pointer to look for
+ *
+ * Looks up the first occurrence of @needle in @pointers.
+ *
+ * Returns: the index of @needle or -1 if not found
+ **/
+gint
+_g_pointer_search (gconstpointer *pointers,
+		   guint          n_pointers,
+		   gconstpointer  needle)
+{
+  pick_search ();
+
+  return search (pointers, n_pointers, needle);
+}
+
+/**
+ * _g_pointer_search_impl:
+ *
+ * Gets the name of the implementation used by _g_pointer_search():
+ * "avx2", "sse2" or "scalar".
+ *
+ * Returns: a static string
+ **/
+const gchar *
+_g_pointer_search_impl (void)
+{
+  pick_search ();
+
+  return search_impl;
+}
@@ -0,0 +1,46 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Search of a pointer in an array, used by the containers keeping their
+ * children in contiguous arrays. On x86 the array is compared several
+ * pointers per instruction with SSE2 or AVX2, as supported by the CPU
+ * running the code: the implementation is chosen on the first call.
+ * Other architectures and compilers use a plain loop.
+ */
+
+
+#ifndef __G_POINTER_SEARCH_H__
+#define __G_POINTER_SEARCH_H__
+
+#include <glib.h>
+
+
+G_BEGIN_DECLS
+
+
+gint		_g_pointer_search	(gconstpointer	*pointers,
+					 guint		 n_pointers,
+					 gconstpointer	 needle);
+const gchar *	_g_pointer_search_impl	(void);
+
+G_END_DECLS
+
+
+#endif /* __G_POINTER_SEARCH_H__ */
@@ -0,0 +1,99 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#include "gsequencewalk.h"
+
+
+/**
+ * _g_sequence_walk_begin:
+ * @walk: the walk to start, usually allocated on the stack
+ * @walks: the location of the walks in progress on @sequence
+ * @sequence: the sequence to walk
+ *
+ * Starts walking @sequence from its first node. Walks on the same
+ * sequence can be nested, but must be ended in reverse order.
+ **/
+void
+_g_sequence_walk_begin (GSequenceWalk  *walk,
+			GSequenceWalk **walks,
+			GSequence      *sequence)
+{
+  walk->next = g_sequence_get_begin_iter (sequence);
+  walk->end = g_sequence_get_end_iter (sequence);
+  walk->outer = *walks;
+  *walks = walk;
+}
+
+/**
+ * _g_sequence_walk_next:
+ * @walk: a walk in progress
+ *
+ * Advances @walk. The end node never changes, so the nodes appended
+ * while walking are reached too.
+ *
+ * Returns: the next node or %NULL when the walk is over
+ **/
+GSequenceIter *
+_g_sequence_walk_next (GSequenceWalk *walk)
+{
+  GSequenceIter *iter;
+
+  iter = walk->next;
+
+  if (iter == walk->end)
+    return NULL;
+
+  walk->next = g_sequence_iter_next (iter);
+  return iter;
+}
+
+/**
+ * _g_sequence_walk_end:
+ * @walk: the innermost walk in progress
+ * @walks: the location of the walks in progress
+ *
+ * Ends @walk, that must be the last one started on its sequence.
+ **/
+void
+_g_sequence_walk_end (GSequenceWalk  *walk,
+		      GSequenceWalk **walks)
+{
+  g_return_if_fail (*walks == walk);
+
+  *walks = walk->outer;
+}
+
+/**
+ * _g_sequence_walk_skip:
+ * @walks: the walks in progress, or %NULL
+ * @iter: a node about to be removed or moved
+ *
+ * Moves past @iter the walks that would reach it next. Must be called
+ * before @iter leaves its place, while it is still linked to its
+ * neighbours.
+ **/
+void
+_g_sequence_walk_skip (GSequenceWalk *walks,
+		       GSequenceIter *iter)
+{
+  for (; walks != NULL; walks = walks->outer)
+    if (walks->next == iter)
+      walks->next = g_sequence_iter_next (iter);
+}
@@ -0,0 +1,62 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Walk of the children of the containers keeping them in a #GSequence.
+ * The callback of a foreach can remove any child, so the node following
+ * the current one cannot simply be fetched in advance: it could be freed
+ * before being reached. Every walk in progress is instead registered in
+ * the container, and the container moves it forward with
+ * _g_sequence_walk_skip() before unlinking a node. Nothing is allocated:
+ * the walks live on the stack of the foreach calls.
+ */
+
+
+#ifndef __G_SEQUENCE_WALK_H__
+#define __G_SEQUENCE_WALK_H__
+
+#include <glib.h>
+
+
+G_BEGIN_DECLS
+
+
+typedef struct _GSequenceWalk GSequenceWalk;
+
+struct _GSequenceWalk
+{
+  GSequenceIter		*next;
+  GSequenceIter		*end;
+  GSequenceWalk		*outer;
+};
+
+
+void		_g_sequence_walk_begin	(GSequenceWalk	*walk,
+					 GSequenceWalk **walks,
+					 GSequence	*sequence);
+GSequenceIter *	_g_sequence_walk_next	(GSequenceWalk	*walk);
+void		_g_sequence_walk_end	(GSequenceWalk	*walk,
+					 GSequenceWalk **walks);
+void		_g_sequence_walk_skip	(GSequenceWalk	*walks,
+					 GSequenceIter	*iter);
+
+G_END_DECLS
+
+
+#endif /* __G_SEQUENCE_WALK_H__ */
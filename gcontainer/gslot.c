@@ -0,0 +1,486 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:gslot
+ * @short_description: A positional object container
+ *
+ * A #GSlot is a #GContainerable whose children can be inserted at,
+ * removed from and looked up by a known position. The children are kept
+ * in a #GSequence, a balanced tree indexed by position, so all these
+ * operations are O(log n) also on containers with a lot of children.
+ * Every child is also indexed by its tree node, so removing a child or
+ * checking if it is inside the slot does not need to search for it.
+ *
+ * g_containerable_add() and the #GContainerable:child property still
+ * append the child: use g_slot_insert() to specify a position.
+ **/
+
+/**
+ * GSlot:
+ *
+ * All the fields in the GSlot structure are private and should never
+ * be accessed directly.
+ **/
+
+#include "gslot.h"
+#include "gslotprivate.h"
+#include "gcontainerableprivate.h"
+#include "gchildprivate.h"
+#include "gifacecache.h"
+
+
+enum
+{
+  PROP_0,
+  PROP_CHILD
+};
+
+
+static void	containerable_init	(GContainerableIface *iface);
+static void	finalize		(GObject	*object);
+static void     set_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         const GValue	*value,
+                                         GParamSpec	*pspec);
+static GSList * get_children		(GContainerable	*containerable);
+static gboolean add			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gboolean remove			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+                                         GFunc		 func,
+                                         gpointer	 user_data);
+static gboolean add_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static gboolean remove_many		(GContainerable	*containerable,
+                                         guint		 n_children,
+                                         GChildable    **children);
+static guint *	get_flags		(GContainerable	*containerable);
+static guint	n_children		(GContainerable	*containerable);
+static gboolean contains		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static GChildable *
+		get_nth			(GContainerable	*containerable,
+                                         guint		 nth);
+static gboolean add_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gboolean remove_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gint	get_position		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gboolean insert			(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         gint		 position,
+                                         guint		*index);
+static GSequenceIter *
+		insertion_point		(GSlot		*slot,
+                                         gint		 position);
+
+
+G_DEFINE_TYPE_EXTENDED (GSlot, g_slot, G_TYPE_CHILD, 0, 
+                        G_IMPLEMENT_INTERFACE (G_TYPE_CONTAINERABLE, 
+                                               containerable_init));
+
+
+static void
+containerable_init (GContainerableIface *iface)
+{
+  iface->get_children = get_children;
+  iface->add = add;
+  iface->remove = remove;
+  iface->foreach = foreach;
+  iface->add_many = add_many;
+  iface->remove_many = remove_many;
+  iface->get_flags = get_flags;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
+  iface->add_indexed = add_indexed;
+  iface->remove_indexed = remove_indexed;
+  iface->get_position = get_position;
+}
+
+static void
+g_slot_class_init (GSlotClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = (GObjectClass *) klass;
+
+  g_type_class_add_private (klass, sizeof (GSlotPrivate));
+
+  gobject_class->set_property = set_property;
+  gobject_class->dispose = g_containerable_dispose;
+  gobject_class->finalize = finalize;
+
+  g_object_class_override_property (gobject_class, PROP_CHILD, "child");
+}
+
+static void
+g_slot_init (GSlot *slot)
+{
+  slot->priv = G_TYPE_INSTANCE_GET_PRIVATE (slot, G_TYPE_SLOT, GSlotPrivate);
+  slot->priv->children = g_sequence_new (NULL);
+  slot->priv->iters = g_hash_table_new (NULL, NULL);
+  slot->priv->walks = NULL;
+}
+
+static void
+finalize (GObject *object)
+{
+  GSlot *slot = (GSlot *) object;
+
+  g_sequence_free (slot->priv->children);
+  g_hash_table_destroy (slot->priv->iters);
+
+  G_OBJECT_CLASS (g_slot_parent_class)->finalize (object);
+}
+
+static void
+set_property (GObject      *object,
+	      guint         prop_id,
+	      const GValue *value,
+	      GParamSpec   *pspec)
+{
+  GContainerable *containerable = (GContainerable *) object;
+
+  switch (prop_id)
+    {
+    case PROP_CHILD:
+      g_containerable_add (containerable, g_value_get_object (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+
+/* A negative or too big @position appends */
+
+static GSequenceIter *
+insertion_point (GSlot *slot,
+		 gint   position)
+{
+  if (position < 0 || position >= g_sequence_get_length (slot->priv->children))
+    return g_sequence_get_end_iter (slot->priv->children);
+
+  return g_sequence_get_iter_at_pos (slot->priv->children, position);
+}
+
+static GSList *
+get_children (GContainerable *containerable)
+{
+  GSlot         *slot;
+  GSList        *children;
+  GSequenceIter *iter, *begin;
+
+  slot = (GSlot *) containerable;
+  children = NULL;
+  iter = g_sequence_get_end_iter (slot->priv->children);
+  begin = g_sequence_get_begin_iter (slot->priv->children);
+
+  /* Walking backward allows to build the list by prepending */
+  while (iter != begin)
+    {
+      iter = g_sequence_iter_prev (iter);
+      children = g_slist_prepend (children, g_sequence_get (iter));
+    }
+
+  return children;
+}
+
+static gboolean
+add (GContainerable *containerable,
+     GChildable     *childable)
+{
+  return add_indexed (containerable, childable, NULL);
+}
+
+static gboolean
+remove (GContainerable *containerable,
+	GChildable     *childable)
+{
+  return remove_indexed (containerable, childable, NULL);
+}
+
+/* A %NULL @position is accepted for the plain add() and remove() */
+
+static gboolean
+add_indexed (GContainerable *containerable,
+	     GChildable     *childable,
+	     guint          *position)
+{
+  return insert (containerable, childable, -1, position);
+}
+
+static gboolean
+remove_indexed (GContainerable *containerable,
+		GChildable     *childable,
+		guint          *position)
+{
+  GSlot         *slot;
+  GSequenceIter *iter;
+
+  slot = (GSlot *) containerable;
+  iter = g_hash_table_lookup (slot->priv->iters, childable);
+
+  if (iter == NULL)
+    return FALSE;
+
+  if (position != NULL)
+    *position = g_sequence_iter_get_position (iter);
+
+  g_hash_table_remove (slot->priv->iters, childable);
+  _g_sequence_walk_skip (slot->priv->walks, iter);
+  g_sequence_remove (iter);
+
+  return TRUE;
+}
+
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GSlot         *slot;
+  GSequenceWalk  walk;
+  GSequenceIter *iter;
+
+  slot = (GSlot *) containerable;
+
+  /* As in GContainer, the removals move the walk past the freed nodes */
+  _g_sequence_walk_begin (&walk, &slot->priv->walks, slot->priv->children);
+
+  while ((iter = _g_sequence_walk_next (&walk)) != NULL)
+    func (g_sequence_get (iter), user_data);
+
+  _g_sequence_walk_end (&walk, &slot->priv->walks);
+}
+
+static gboolean
+add_many (GContainerable *containerable,
+	  guint           n_children,
+	  GChildable    **children)
+{
+  GSlot         *slot;
+  GSequenceIter *point, *iter;
+  guint          n;
+
+  slot = (GSlot *) containerable;
+  point = g_sequence_get_end_iter (slot->priv->children);
+
+  /* Inserting always before the same node keeps the children
+   * contiguous and in the given order */
+  for (n = 0; n < n_children; ++ n)
+    {
+      iter = g_sequence_insert_before (point, children[n]);
+      g_hash_table_insert (slot->priv->iters, children[n], iter);
+    }
+
+  return TRUE;
+}
+
+static gboolean
+remove_many (GContainerable *containerable,
+	     guint           n_children,
+	     GChildable    **children)
+{
+  GSlot         *slot;
+  GSequenceIter *iter;
+  guint          n;
+
+  slot = (GSlot *) containerable;
+
+  /* Check in advance, so nothing is touched if some child is missing */
+  for (n = 0; n < n_children; ++ n)
+    if (!g_hash_table_lookup (slot->priv->iters, children[n]))
+      return FALSE;
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      iter = g_hash_table_lookup (slot->priv->iters, children[n]);
+
+      if (iter)
+	{
+	  g_hash_table_remove (slot->priv->iters, children[n]);
+	  _g_sequence_walk_skip (slot->priv->walks, iter);
+	  g_sequence_remove (iter);
+	}
+    }
+
+  return TRUE;
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+static guint
+n_children (GContainerable *containerable)
+{
+  GSlot *slot = (GSlot *) containerable;
+
+  return g_sequence_get_length (slot->priv->children);
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  GSlot *slot = (GSlot *) containerable;
+
+  return g_hash_table_lookup (slot->priv->iters, childable) != NULL;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  GSlot *slot = (GSlot *) containerable;
+
+  if (nth >= (guint) g_sequence_get_length (slot->priv->children))
+    return NULL;
+
+  return g_sequence_get (g_sequence_get_iter_at_pos (slot->priv->children, nth));
+}
+
+static gint
+get_position (GContainerable *containerable,
+	      GChildable     *childable)
+{
+  GSlot         *slot;
+  GSequenceIter *iter;
+
+  slot = (GSlot *) containerable;
+  iter = g_hash_table_lookup (slot->priv->iters, childable);
+
+  return iter != NULL ? g_sequence_iter_get_position (iter) : -1;
+}
+
+/* The add method of g_slot_insert(), called by the GContainerable
+ * machinery with the position given by the caller */
+
+static gboolean
+insert (GContainerable *containerable,
+	GChildable     *childable,
+	gint            position,
+	guint          *index)
+{
+  GSlot         *slot;
+  GSequenceIter *iter;
+
+  slot = (GSlot *) containerable;
+  iter = g_sequence_insert_before (insertion_point (slot, position), childable);
+  g_hash_table_insert (slot->priv->iters, childable, iter);
+
+  if (index != NULL)
+    *index = g_sequence_iter_get_position (iter);
+
+  return TRUE;
+}
+
+
+/**
+ * g_slot_new:
+ *
+ * Creates a new positional container.
+ *
+ * Return value: a #GSlot instance
+ **/
+GObject *
+g_slot_new (void)
+{
+  return g_object_new (G_TYPE_SLOT, NULL);
+}
+
+/**
+ * g_slot_insert:
+ * @slot: a #GSlot
+ * @childable: a #GObject implementing #GChildable
+ * @position: the position of @childable, starting from 0
+ *
+ * Adds @childable to @slot at @position, shifting the children yet
+ * there (if any) one position forward. If @position is negative or
+ * not less than the number of children, @childable is appended.
+ *
+ * The same signals of g_containerable_add() are emitted.
+ **/
+void
+g_slot_insert (GSlot      *slot,
+	       GChildable *childable,
+	       gint        position)
+{
+  g_return_if_fail (G_IS_SLOT (slot));
+  g_return_if_fail (G_IS_CHILDABLE_CACHED (childable));
+
+  _g_containerable_insert ((GContainerable *) slot, childable, insert, position);
+}
+
+/**
+ * g_slot_remove_nth:
+ * @slot: a #GSlot
+ * @nth: the position of the child to remove, starting from 0
+ *
+ * Removes the child at position @nth from @slot, shifting the
+ * following children one position backward.
+ *
+ * The same signals of g_containerable_remove() are emitted.
+ **/
+void
+g_slot_remove_nth (GSlot *slot,
+		   guint  nth)
+{
+  GChildable *childable;
+
+  g_return_if_fail (G_IS_SLOT (slot));
+
+  childable = get_nth ((GContainerable *) slot, nth);
+
+  g_return_if_fail (childable != NULL);
+
+  g_containerable_remove ((GContainerable *) slot, childable);
+}
+
+/**
+ * g_slot_get_position:
+ * @slot: a #GSlot
+ * @childable: a #GObject implementing #GChildable
+ *
+ * Gets the position of @childable inside @slot.
+ *
+ * Returns: the position of @childable, starting from 0, or -1 if
+ *          @childable is not inside @slot
+ **/
+gint
+g_slot_get_position (GSlot      *slot,
+		     GChildable *childable)
+{
+  g_return_val_if_fail (G_IS_SLOT (slot), -1);
+
+  return get_position ((GContainerable *) slot, childable);
+}
@@ -0,0 +1,70 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef __G_SLOT_H__
+#define __G_SLOT_H__
+
+#include <gcontainer/gchild.h>
+
+
+G_BEGIN_DECLS
+
+
+#define G_TYPE_SLOT             (g_slot_get_type ())
+#define G_SLOT(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), G_TYPE_SLOT, GSlot))
+#define G_SLOT_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), G_TYPE_SLOT, GSlotClass))
+#define G_IS_SLOT(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), G_TYPE_SLOT))
+#define G_IS_SLOT_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), G_TYPE_SLOT))
+#define G_SLOT_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), G_TYPE_SLOT, GSlotClass))
+
+
+typedef struct _GSlot		GSlot;
+typedef struct _GSlotClass	GSlotClass;
+typedef struct _GSlotPrivate	GSlotPrivate;
+
+struct _GSlot
+{
+  GChild		 child;
+
+  /*< private >*/
+  GSlotPrivate		*priv;
+};
+
+struct _GSlotClass
+{
+  GChildClass		 parent_class;
+};
+
+
+GType			g_slot_get_type		(void) G_GNUC_CONST;
+GObject *		g_slot_new		(void);
+void			g_slot_insert		(GSlot		*slot,
+						 GChildable	*childable,
+						 gint		 position);
+void			g_slot_remove_nth	(GSlot		*slot,
+						 guint		 nth);
+gint			g_slot_get_position	(GSlot		*slot,
+						 GChildable	*childable);
+
+
+G_END_DECLS
+
+
+#endif /* __G_SLOT_H__ */
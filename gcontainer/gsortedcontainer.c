@@ -0,0 +1,581 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:gsortedcontainer
+ * @short_description: A container keeping its children sorted
+ *
+ * A #GSortedContainer is a #GContainerable whose children are always
+ * iterated in the order defined by a #GCompareDataFunc, so there is no
+ * need to sort a copy of the children on every read. The children are
+ * kept in a #GSequence, a balanced tree: adding and removing a child are
+ * O(log n), and g_sorted_container_find() and
+ * g_sorted_container_lower_bound() do a binary search. Children comparing
+ * equal are kept in the order they were added.
+ *
+ * If the order depends on a property of the children, pass its name as
+ * #GSortedContainer:sort-property: whenever a child notifies a change of
+ * that property, only that child is moved to its new place. Changes of
+ * any other state used by the comparison function are not detected.
+ **/
+
+/**
+ * GSortedContainer:
+ *
+ * All the fields in the GSortedContainer structure are private and should
+ * never be accessed directly.
+ **/
+
+#include "gsortedcontainer.h"
+#include "gsortedcontainerprivate.h"
+#include "gcontainerableprivate.h"
+#include "gchildprivate.h"
+#include "gcontainerintl.h"
+
+
+enum
+{
+  PROP_0,
+  PROP_CHILD,
+  PROP_SORT_PROPERTY
+};
+
+
+typedef struct _SearchData SearchData;
+
+struct _SearchData
+{
+  gconstpointer		 key;
+  GCompareDataFunc	 func;
+  gpointer		 data;
+};
+
+
+static void	containerable_init	(GContainerableIface *iface);
+static void	finalize		(GObject	*object);
+static void	get_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         GValue		*value,
+                                         GParamSpec	*pspec);
+static void     set_property		(GObject	*object,
+                                         guint		 prop_id,
+                                         const GValue	*value,
+                                         GParamSpec	*pspec);
+static GSList * get_children		(GContainerable	*containerable);
+static gboolean add			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static gboolean remove			(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	foreach			(GContainerable	*containerable,
+                                         GFunc		 func,
+                                         gpointer	 user_data);
+static guint *	get_flags		(GContainerable	*containerable);
+static guint	n_children		(GContainerable	*containerable);
+static gboolean contains		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static GChildable *
+		get_nth			(GContainerable	*containerable,
+                                         guint		 nth);
+static gboolean add_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gboolean remove_indexed		(GContainerable	*containerable,
+                                         GChildable	*childable,
+                                         guint		*position);
+static gint	get_position		(GContainerable	*containerable,
+                                         GChildable	*childable);
+static void	resort_child		(GChildable	*childable,
+                                         GParamSpec	*pspec,
+                                         GSortedContainer *sorted_container);
+static GSequenceIter *
+		lower_bound		(GSortedContainer *sorted_container,
+                                         SearchData	*search);
+static gint	search_compare		(gconstpointer	 a,
+                                         gconstpointer	 b,
+                                         gpointer	 user_data);
+
+
+G_DEFINE_TYPE_EXTENDED (GSortedContainer, g_sorted_container, G_TYPE_CHILD, 0, 
+                        G_IMPLEMENT_INTERFACE (G_TYPE_CONTAINERABLE, 
+                                               containerable_init));
+
+
+static void
+containerable_init (GContainerableIface *iface)
+{
+  iface->get_children = get_children;
+  iface->add = add;
+  iface->remove = remove;
+  iface->foreach = foreach;
+  iface->get_flags = get_flags;
+  iface->n_children = n_children;
+  iface->contains = contains;
+  iface->get_nth = get_nth;
+  iface->add_indexed = add_indexed;
+  iface->remove_indexed = remove_indexed;
+  iface->get_position = get_position;
+}
+
+static void
+g_sorted_container_class_init (GSortedContainerClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = (GObjectClass *) klass;
+
+  g_type_class_add_private (klass, sizeof (GSortedContainerPrivate));
+
+  gobject_class->get_property = get_property;
+  gobject_class->set_property = set_property;
+  gobject_class->dispose = g_containerable_dispose;
+  gobject_class->finalize = finalize;
+
+  g_object_class_override_property (gobject_class, PROP_CHILD, "child");
+
+  /**
+   * GSortedContainer:sort-property:
+   *
+   * The name of the property of the children the order depends on, or
+   * %NULL. Can be set only at construction time.
+   **/
+  g_object_class_install_property (gobject_class, PROP_SORT_PROPERTY,
+				   g_param_spec_string ("sort-property",
+							P_("Sort property"),
+							P_("The property of the children the order depends on"),
+							NULL,
+							G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+}
+
+static void
+g_sorted_container_init (GSortedContainer *sorted_container)
+{
+  sorted_container->priv = G_TYPE_INSTANCE_GET_PRIVATE (sorted_container,
+							G_TYPE_SORTED_CONTAINER,
+							GSortedContainerPrivate);
+  sorted_container->priv->children = g_sequence_new (NULL);
+  sorted_container->priv->iters = g_hash_table_new (NULL, NULL);
+  sorted_container->priv->walks = NULL;
+  sorted_container->priv->sort_property = NULL;
+  sorted_container->priv->notify_signal = NULL;
+  sorted_container->priv->compare_func = NULL;
+  sorted_container->priv->compare_data = NULL;
+  sorted_container->priv->compare_notify = NULL;
+}
+
+static void
+finalize (GObject *object)
+{
+  GSortedContainer *sorted_container = (GSortedContainer *) object;
+
+  g_sequence_free (sorted_container->priv->children);
+  g_hash_table_destroy (sorted_container->priv->iters);
+  g_free (sorted_container->priv->sort_property);
+  g_free (sorted_container->priv->notify_signal);
+
+  if (sorted_container->priv->compare_notify != NULL)
+    sorted_container->priv->compare_notify (sorted_container->priv->compare_data);
+
+  G_OBJECT_CLASS (g_sorted_container_parent_class)->finalize (object);
+}
+
+static void
+get_property (GObject    *object,
+	      guint       prop_id,
+	      GValue     *value,
+	      GParamSpec *pspec)
+{
+  GSortedContainer *sorted_container = (GSortedContainer *) object;
+
+  switch (prop_id)
+    {
+    case PROP_SORT_PROPERTY:
+      g_value_set_string (value, sorted_container->priv->sort_property);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+set_property (GObject      *object,
+	      guint         prop_id,
+	      const GValue *value,
+	      GParamSpec   *pspec)
+{
+  GContainerable   *containerable = (GContainerable *) object;
+  GSortedContainer *sorted_container = (GSortedContainer *) object;
+
+  switch (prop_id)
+    {
+    case PROP_CHILD:
+      g_containerable_add (containerable, g_value_get_object (value));
+      break;
+    case PROP_SORT_PROPERTY:
+      sorted_container->priv->sort_property = g_value_dup_string (value);
+      if (sorted_container->priv->sort_property != NULL)
+	sorted_container->priv->notify_signal =
+	  g_strconcat ("notify::", sorted_container->priv->sort_property, NULL);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+
+static GSList *
+get_children (GContainerable *containerable)
+{
+  GSortedContainer *sorted_container;
+  GSList           *children;
+  GSequenceIter    *iter, *begin;
+
+  sorted_container = (GSortedContainer *) containerable;
+  children = NULL;
+  iter = g_sequence_get_end_iter (sorted_container->priv->children);
+  begin = g_sequence_get_begin_iter (sorted_container->priv->children);
+
+  /* Walking backward allows to build the list by prepending */
+  while (iter != begin)
+    {
+      iter = g_sequence_iter_prev (iter);
+      children = g_slist_prepend (children, g_sequence_get (iter));
+    }
+
+  return children;
+}
+
+static gboolean
+add (GContainerable *containerable,
+     GChildable     *childable)
+{
+  return add_indexed (containerable, childable, NULL);
+}
+
+static gboolean
+remove (GContainerable *containerable,
+	GChildable     *childable)
+{
+  return remove_indexed (containerable, childable, NULL);
+}
+
+/* A %NULL @position is accepted for the plain add() and remove() */
+
+static gboolean
+add_indexed (GContainerable *containerable,
+	     GChildable     *childable,
+	     guint          *position)
+{
+  GSortedContainer *sorted_container;
+  GSequenceIter    *iter;
+
+  sorted_container = (GSortedContainer *) containerable;
+
+  /* Without a compare function (only possible when created by
+   * g_object_new()) the children are kept in insertion order */
+  if (sorted_container->priv->compare_func == NULL)
+    iter = g_sequence_append (sorted_container->priv->children, childable);
+  else
+    iter = g_sequence_insert_sorted (sorted_container->priv->children,
+				     childable,
+				     sorted_container->priv->compare_func,
+				     sorted_container->priv->compare_data);
+
+  g_hash_table_insert (sorted_container->priv->iters, childable, iter);
+
+  if (position != NULL)
+    *position = g_sequence_iter_get_position (iter);
+
+  if (sorted_container->priv->notify_signal != NULL &&
+      sorted_container->priv->compare_func != NULL)
+    g_signal_connect (childable, sorted_container->priv->notify_signal,
+		      G_CALLBACK (resort_child), sorted_container);
+
+  return TRUE;
+}
+
+static gboolean
+remove_indexed (GContainerable *containerable,
+		GChildable     *childable,
+		guint          *position)
+{
+  GSortedContainer *sorted_container;
+  GSequenceIter    *iter;
+
+  sorted_container = (GSortedContainer *) containerable;
+  iter = g_hash_table_lookup (sorted_container->priv->iters, childable);
+
+  if (iter == NULL)
+    return FALSE;
+
+  if (position != NULL)
+    *position = g_sequence_iter_get_position (iter);
+
+  if (sorted_container->priv->notify_signal != NULL &&
+      sorted_container->priv->compare_func != NULL)
+    g_signal_handlers_disconnect_by_func (childable, resort_child,
+					  sorted_container);
+
+  g_hash_table_remove (sorted_container->priv->iters, childable);
+  _g_sequence_walk_skip (sorted_container->priv->walks, iter);
+  g_sequence_remove (iter);
+
+  return TRUE;
+}
+
+static void
+foreach (GContainerable *containerable,
+	 GFunc           func,
+	 gpointer        user_data)
+{
+  GSortedContainer *sorted_container;
+  GSequenceWalk     walk;
+  GSequenceIter    *iter;
+
+  sorted_container = (GSortedContainer *) containerable;
+
+  /* As in GContainer, the removals move the walk past the freed nodes */
+  _g_sequence_walk_begin (&walk, &sorted_container->priv->walks,
+			  sorted_container->priv->children);
+
+  while ((iter = _g_sequence_walk_next (&walk)) != NULL)
+    func (g_sequence_get (iter), user_data);
+
+  _g_sequence_walk_end (&walk, &sorted_container->priv->walks);
+}
+
+static guint *
+get_flags (GContainerable *containerable)
+{
+  /* Share the flags of the GChild parent class, so the GChildable and
+   * GContainerable interfaces see the same bits */
+  return &((GChild *) containerable)->priv->flags;
+}
+
+static guint
+n_children (GContainerable *containerable)
+{
+  GSortedContainer *sorted_container = (GSortedContainer *) containerable;
+
+  return g_sequence_get_length (sorted_container->priv->children);
+}
+
+static gboolean
+contains (GContainerable *containerable,
+	  GChildable     *childable)
+{
+  GSortedContainer *sorted_container = (GSortedContainer *) containerable;
+
+  return g_hash_table_lookup (sorted_container->priv->iters, childable) != NULL;
+}
+
+static GChildable *
+get_nth (GContainerable *containerable,
+	 guint           nth)
+{
+  GSortedContainer *sorted_container = (GSortedContainer *) containerable;
+
+  if (nth >= (guint) g_sequence_get_length (sorted_container->priv->children))
+    return NULL;
+
+  return g_sequence_get (g_sequence_get_iter_at_pos (sorted_container->priv->children,
+						     nth));
+}
+
+static gint
+get_position (GContainerable *containerable,
+	      GChildable     *childable)
+{
+  GSortedContainer *sorted_container;
+  GSequenceIter    *iter;
+
+  sorted_container = (GSortedContainer *) containerable;
+  iter = g_hash_table_lookup (sorted_container->priv->iters, childable);
+
+  return iter != NULL ? g_sequence_iter_get_position (iter) : -1;
+}
+
+static void
+resort_child (GChildable       *childable,
+	      GParamSpec       *pspec,
+	      GSortedContainer *sorted_container)
+{
+  GSequenceIter *iter;
+  gboolean       track;
+  gint           old_position, new_position;
+
+  iter = g_hash_table_lookup (sorted_container->priv->iters, childable);
+  track = _g_containerable_tracks_children ((GContainerable *) sorted_container);
+  old_position = track ? g_sequence_iter_get_position (iter) : 0;
+
+  /* Only this child is moved, in O(log n). A walk that was about to
+   * reach it goes on from its old place instead of jumping with it */
+  _g_sequence_walk_skip (sorted_container->priv->walks, iter);
+  g_sequence_sort_changed (iter,
+			   sorted_container->priv->compare_func,
+			   sorted_container->priv->compare_data);
+
+  if (!track)
+    return;
+
+  /* The children between the old and the new place are shifted by one:
+   * the whole range is notified as replaced */
+  new_position = g_sequence_iter_get_position (iter);
+
+  if (new_position != old_position)
+    _g_containerable_children_changed ((GContainerable *) sorted_container,
+				       MIN (old_position, new_position),
+				       ABS (new_position - old_position) + 1,
+				       ABS (new_position - old_position) + 1);
+}
+
+/* The binary search of GSequence compares the children with a probe item,
+ * here the SearchData itself, that can be passed on either side. A child
+ * equal to the key is considered greater than the probe, so the search
+ * stops on the first of them. */
+
+static GSequenceIter *
+lower_bound (GSortedContainer *sorted_container,
+	     SearchData       *search)
+{
+  return g_sequence_search (sorted_container->priv->children, search,
+			    search_compare, search);
+}
+
+static gint
+search_compare (gconstpointer a,
+		gconstpointer b,
+		gpointer      user_data)
+{
+  SearchData *search = user_data;
+
+  if (b == search)
+    return search->func (a, search->key, search->data) >= 0 ? 1 : -1;
+
+  return search->func (b, search->key, search->data) >= 0 ? -1 : 1;
+}
+
+
+/**
+ * g_sorted_container_new:
+ * @sort_property: the name of the property of the children the order
+ *                 depends on, or %NULL
+ * @compare_func: the function defining the order of the children
+ * @user_data: data to pass to @compare_func
+ * @notify: function to call on @user_data when the container is
+ *          finalized, or %NULL
+ *
+ * Creates a new container that keeps its children sorted by
+ * @compare_func, which is called with two children.
+ *
+ * Return value: a #GSortedContainer instance
+ **/
+GObject *
+g_sorted_container_new (const gchar      *sort_property,
+			GCompareDataFunc  compare_func,
+			gpointer          user_data,
+			GDestroyNotify    notify)
+{
+  GSortedContainer *sorted_container;
+
+  g_return_val_if_fail (compare_func != NULL, NULL);
+
+  sorted_container = g_object_new (G_TYPE_SORTED_CONTAINER,
+				   "sort-property", sort_property,
+				   NULL);
+  sorted_container->priv->compare_func = compare_func;
+  sorted_container->priv->compare_data = user_data;
+  sorted_container->priv->compare_notify = notify;
+
+  return (GObject *) sorted_container;
+}
+
+/**
+ * g_sorted_container_find:
+ * @sorted_container: a #GSortedContainer
+ * @key: the key to look for
+ * @key_compare_func: the function comparing a child (first argument)
+ *                    with @key (second argument), consistent with the
+ *                    order of the container
+ * @user_data: data to pass to @key_compare_func
+ *
+ * Looks up a child equal to @key with a binary search. If more children
+ * are equal to @key, the first one is returned.
+ *
+ * Returns: the child equal to @key or %NULL if not found
+ **/
+GChildable *
+g_sorted_container_find (GSortedContainer *sorted_container,
+			 gconstpointer     key,
+			 GCompareDataFunc  key_compare_func,
+			 gpointer          user_data)
+{
+  SearchData     search;
+  GSequenceIter *iter;
+  GChildable    *childable;
+
+  g_return_val_if_fail (G_IS_SORTED_CONTAINER (sorted_container), NULL);
+  g_return_val_if_fail (key_compare_func != NULL, NULL);
+
+  search.key = key;
+  search.func = key_compare_func;
+  search.data = user_data;
+  iter = lower_bound (sorted_container, &search);
+
+  if (g_sequence_iter_is_end (iter))
+    return NULL;
+
+  childable = g_sequence_get (iter);
+
+  return key_compare_func (childable, key, user_data) == 0 ? childable : NULL;
+}
+
+/**
+ * g_sorted_container_lower_bound:
+ * @sorted_container: a #GSortedContainer
+ * @key: the key to look for
+ * @key_compare_func: the function comparing a child (first argument)
+ *                    with @key (second argument), consistent with the
+ *                    order of the container
+ * @user_data: data to pass to @key_compare_func
+ *
+ * Looks up with a binary search the position of the first child not
+ * less than @key, that is where a child equal to @key would be placed.
+ * The child itself can be fetched with g_containerable_get_nth().
+ *
+ * Returns: the position of the first child not less than @key, or the
+ *          number of children if all of them are less than @key
+ **/
+guint
+g_sorted_container_lower_bound (GSortedContainer *sorted_container,
+				gconstpointer     key,
+				GCompareDataFunc  key_compare_func,
+				gpointer          user_data)
+{
+  SearchData search;
+
+  g_return_val_if_fail (G_IS_SORTED_CONTAINER (sorted_container), 0);
+  g_return_val_if_fail (key_compare_func != NULL, 0);
+
+  search.key = key;
+  search.func = key_compare_func;
+  search.data = user_data;
+
+  return g_sequence_iter_get_position (lower_bound (sorted_container, &search));
+}
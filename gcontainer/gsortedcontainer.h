@@ -0,0 +1,74 @@
+/* gcontainer - A generic container for the glib-2.0 library
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the 
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef __G_SORTED_CONTAINER_H__
+#define __G_SORTED_CONTAINER_H__
+
+#include <gcontainer/gchild.h>
+
+
+G_BEGIN_DECLS
+
+
+#define G_TYPE_SORTED_CONTAINER             (g_sorted_container_get_type ())
+#define G_SORTED_CONTAINER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), G_TYPE_SORTED_CONTAINER, GSortedContainer))
+#define G_SORTED_CONTAINER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), G_TYPE_SORTED_CONTAINER, GSortedContainerClass))
+#define G_IS_SORTED_CONTAINER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), G_TYPE_SORTED_CONTAINER))
+#define G_IS_SORTED_CONTAINER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), G_TYPE_SORTED_CONTAINER))
+#define G_SORTED_CONTAINER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), G_TYPE_SORTED_CONTAINER, GSortedContainerClass))
+
+
+typedef struct _GSortedContainer	GSortedContainer;
+typedef struct _GSortedContainerClass	GSortedContainerClass;
+typedef struct _GSortedContainerPrivate	GSortedContainerPrivate;
+
+struct _GSortedContainer
+{
+  GChild			 child;
+
+  /*< private >*/
+  GSortedContainerPrivate	*priv;
+};
+
+struct _GSortedContainerClass
+{
+  GChildClass			 parent_class;
+};
+
+
+GType		g_sorted_container_get_type	(void) G_GNUC_CONST;
+GObject *	g_sorted_container_new		(const gchar	*sort_property,
+						 GCompareDataFunc compare_func,
+						 gpointer	 user_data,
+						 GDestroyNotify	 notify);
+GChildable *	g_sorted_container_find		(GSortedContainer *sorted_container,
+						 gconstpointer	 key,
+						 GCompareDataFunc key_compare_func,
+						 gpointer	 user_data);
+guint		g_sorted_container_lower_bound	(GSortedContainer *sorted_container,
+						 gconstpointer	 key,
+						 GCompareDataFunc key_compare_func,
+						 gpointer	 user_data);
+
+
+G_END_DECLS
+
+
+#endif /* __G_SORTED_CONTAINER_H__ */
@@ -0,0 +1,1347 @@
+/* libgcontainer - Benchmark program
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/*
+ * Microbenchmarks of the hot paths of libgcontainer.
+ *
+ * Run without arguments to execute all the benchmarks or pass the names
+ * of the benchmarks you are interested in.
+ */
+
+#include <gcontainer/gcontainer.h>
+#include <string.h>
+
+/* Private header, not installed: only used to benchmark the search
+ * kernel on arrays larger than the chunks of GChunkedContainer */
+#include <gcontainer/gpointersearch.h>
+
+
+typedef void (*BenchFunc) (void);
+
+typedef struct _Bench Bench;
+
+struct _Bench
+{
+  const gchar	*name;
+  BenchFunc	 func;
+};
+
+
+static void	bench_emission		(void);
+static void	bench_propagate		(void);
+static void	bench_destroy		(void);
+static void	bench_hot_paths		(void);
+static void	bench_pool		(void);
+static void	bench_threads		(void);
+static void	bench_snapshot		(void);
+static void	bench_collector		(void);
+static void	bench_queries		(void);
+static void	bench_slot		(void);
+static void	bench_keyed		(void);
+static void	bench_sorted		(void);
+static void	bench_iteration		(void);
+static void	bench_search		(void);
+static void	bench_tracking		(void);
+
+
+static const Bench benchs[] =
+{
+  { "emission",		bench_emission },
+  { "propagate",	bench_propagate },
+  { "destroy",		bench_destroy },
+  { "hot-paths",	bench_hot_paths },
+  { "pool",		bench_pool },
+  { "threads",		bench_threads },
+  { "snapshot",		bench_snapshot },
+  { "collector",	bench_collector },
+  { "queries",		bench_queries },
+  { "slot",		bench_slot },
+  { "keyed",		bench_keyed },
+  { "sorted",		bench_sorted },
+  { "iteration",	bench_iteration },
+  { "search",		bench_search },
+  { "tracking",		bench_tracking }
+};
+
+
+/* Reporting */
+
+static void
+report (const gchar *what,
+        gdouble      seconds,
+        guint        n_ops)
+{
+  g_print ("  %-48s %10.1f ns/op\n", what, seconds * 1e9 / n_ops);
+}
+
+
+/* Signal emission: two clones of "parent-set" are registered, with and
+ * without a va_list marshaller, and compared against the real signal */
+
+static void
+parent_set_handler (GChildable     *childable,
+                    GContainerable *old_parent,
+                    gpointer        user_data)
+{
+  ++ *(guint *) user_data;
+}
+
+static void
+bench_emission (void)
+{
+  const guint n_emissions = 1000000;
+  GObject    *child;
+  GObject    *container;
+  guint       signal_id, generic_id, va_id;
+  guint       n, counter;
+  GTimer     *timer;
+
+  child = g_object_ref_sink (g_child_new ());
+  container = g_object_ref_sink (g_container_new ());
+
+  /* The interface signals are registered with the first instance */
+  signal_id = g_signal_lookup ("parent-set", G_TYPE_CHILDABLE);
+  generic_id = g_signal_new ("generic-parent-set",
+                             G_TYPE_CHILD,
+                             G_SIGNAL_RUN_FIRST,
+                             0, NULL, NULL,
+                             g_cclosure_marshal_VOID__OBJECT,
+                             G_TYPE_NONE, 1, G_TYPE_OBJECT);
+  va_id = g_signal_new ("va-parent-set",
+                        G_TYPE_CHILD,
+                        G_SIGNAL_RUN_FIRST,
+                        0, NULL, NULL,
+                        g_cclosure_marshal_VOID__OBJECT,
+                        G_TYPE_NONE, 1, G_TYPE_OBJECT);
+  g_signal_set_va_marshaller (va_id, G_TYPE_CHILD,
+                              g_cclosure_marshal_VOID__OBJECTv);
+  counter = 0;
+
+  g_signal_connect (child, "parent-set",
+                    G_CALLBACK (parent_set_handler), &counter);
+  g_signal_connect (child, "generic-parent-set",
+                    G_CALLBACK (parent_set_handler), &counter);
+  g_signal_connect (child, "va-parent-set",
+                    G_CALLBACK (parent_set_handler), &counter);
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_emissions; ++ n)
+    g_signal_emit (child, generic_id, 0, container);
+  g_timer_stop (timer);
+  report ("VOID:OBJECT emission, generic marshaller",
+          g_timer_elapsed (timer, NULL), n_emissions);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_emissions; ++ n)
+    g_signal_emit (child, va_id, 0, container);
+  g_timer_stop (timer);
+  report ("VOID:OBJECT emission, va_list marshaller",
+          g_timer_elapsed (timer, NULL), n_emissions);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_emissions; ++ n)
+    g_signal_emit (child, signal_id, 0, container);
+  g_timer_stop (timer);
+  report ("GChildable::parent-set emission",
+          g_timer_elapsed (timer, NULL), n_emissions);
+
+  g_assert (counter == n_emissions * 3);
+
+  g_timer_destroy (timer);
+  g_object_unref (container);
+  g_object_unref (child);
+}
+
+
+/* Signal propagation: broadcasting a VOID:INT,STRING signal to a wide
+ * container, compared with a g_signal_emit() per child */
+
+static void
+ping_handler (GObject     *object,
+              gint         value,
+              const gchar *string,
+              gpointer     user_data)
+{
+  ++ *(guint *) user_data;
+}
+
+static void
+emit_ping (GObject *child,
+           guint   *signal_id)
+{
+  g_signal_emit (child, *signal_id, 0, 1, "ping");
+}
+
+static void
+bench_propagate (void)
+{
+  const guint     n_children = 1000;
+  const guint     n_rounds = 1000;
+  GContainerable *container;
+  GObject        *child;
+  GValue          params[2] = { { 0, }, { 0, } };
+  guint           signal_id;
+  guint           n, counter;
+  GTimer         *timer;
+
+  signal_id = g_signal_new ("ping",
+                            G_TYPE_CHILD,
+                            G_SIGNAL_RUN_LAST,
+                            0, NULL, NULL,
+                            g_cclosure_marshal_generic,
+                            G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_STRING);
+
+  container = g_object_ref_sink (g_container_new ());
+  counter = 0;
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      child = g_child_new ();
+      g_signal_connect (child, "ping", G_CALLBACK (ping_handler), &counter);
+      g_containerable_add (container, G_CHILDABLE (child));
+    }
+
+  g_value_init (&params[0], G_TYPE_INT);
+  g_value_set_int (&params[0], 1);
+  g_value_init (&params[1], G_TYPE_STRING);
+  g_value_set_static_string (&params[1], "ping");
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_containerable_foreach (container, G_CALLBACK (emit_ping), &signal_id);
+  g_timer_stop (timer);
+  report ("g_signal_emit() per child",
+          g_timer_elapsed (timer, NULL), n_rounds * n_children);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_containerable_propagate (container, signal_id, 0, 1, "ping");
+  g_timer_stop (timer);
+  report ("g_containerable_propagate() per child",
+          g_timer_elapsed (timer, NULL), n_rounds * n_children);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_containerable_propagatev (container, signal_id, 0, params, NULL);
+  g_timer_stop (timer);
+  report ("g_containerable_propagatev() per child",
+          g_timer_elapsed (timer, NULL), n_rounds * n_children);
+
+  g_assert (counter == n_rounds * n_children * 3);
+
+  g_value_unset (&params[1]);
+  g_value_unset (&params[0]);
+  g_timer_destroy (timer);
+  g_object_unref (container);
+}
+
+
+/* Tree destruction: a container with a lot of children and a chain of
+ * nested bins, deep enough to overflow the stack of a recursive dispose */
+
+typedef struct
+{
+  GTimer   *timer;
+  gdouble   max_elapsed;
+  gboolean  done;
+} DestroyData;
+
+static void
+destroy_progress (guint        n_disposed,
+                  guint        n_pending,
+                  DestroyData *data)
+{
+  gdouble elapsed = g_timer_elapsed (data->timer, NULL);
+
+  if (elapsed > data->max_elapsed)
+    data->max_elapsed = elapsed;
+
+  data->done = n_pending == 0;
+  g_timer_start (data->timer);
+}
+
+static void
+bench_destroy (void)
+{
+  const guint     n_wide = 100000;
+  const guint     n_deep = 1000000;
+  GContainerable *root;
+  GContainerable *parent;
+  GObject        *child;
+  guint           n;
+  GTimer         *timer;
+  DestroyData     data;
+
+  timer = g_timer_new ();
+
+  root = g_object_ref_sink (g_container_new ());
+  for (n = 0; n < n_wide; ++ n)
+    g_containerable_add (root, G_CHILDABLE (g_child_new ()));
+
+  g_timer_start (timer);
+  g_object_unref (root);
+  g_timer_stop (timer);
+  report ("destroy a container with 100000 children",
+          g_timer_elapsed (timer, NULL), n_wide);
+
+  root = g_object_ref_sink (g_bin_new ());
+  parent = root;
+  for (n = 0; n < n_deep; ++ n)
+    {
+      child = g_bin_new ();
+      g_containerable_add (parent, G_CHILDABLE (child));
+      parent = G_CONTAINERABLE (child);
+    }
+
+  g_timer_start (timer);
+  g_object_unref (root);
+  g_timer_stop (timer);
+  report ("destroy a chain of 1000000 nested bins",
+          g_timer_elapsed (timer, NULL), n_deep);
+
+  /* The same chain released in chunks of 1000 objects from an idle source */
+  root = g_object_ref_sink (g_bin_new ());
+  parent = root;
+  for (n = 0; n < n_deep; ++ n)
+    {
+      child = g_bin_new ();
+      g_containerable_add (parent, G_CHILDABLE (child));
+      parent = G_CONTAINERABLE (child);
+    }
+
+  data.timer = g_timer_new ();
+  data.max_elapsed = 0;
+  data.done = FALSE;
+
+  g_timer_start (timer);
+  g_containerable_dispose_async (root, NULL, 1000,
+                                 (GContainerableProgressFunc) destroy_progress,
+                                 &data, NULL);
+  g_timer_start (data.timer);
+  while (!data.done)
+    g_main_context_iteration (NULL, TRUE);
+  g_timer_stop (timer);
+  g_object_unref (root);
+
+  report ("destroy the same chain asynchronously",
+          g_timer_elapsed (timer, NULL), n_deep);
+  g_print ("  %-48s %10.1f ms\n", "longest main loop iteration",
+           data.max_elapsed * 1e3);
+
+  g_timer_destroy (data.timer);
+  g_timer_destroy (timer);
+}
+
+
+/* Hot paths: adding, removing and getting the parent of a child, without
+ * any handler connected, on a GContainer and on a GBin, with and without
+ * argument validation */
+
+static void
+bench_hot_paths (void)
+{
+  const guint     n_ops = 1000000;
+  GContainerable *container;
+  GContainerable *bin;
+  GChildable     *child;
+  GContainerable *parent;
+  guint           n;
+  GTimer         *timer;
+
+  container = g_object_ref_sink (g_container_new ());
+  bin = g_object_ref_sink (g_bin_new ());
+  child = g_object_ref_sink (g_child_new ());
+  parent = NULL;
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_ops; ++ n)
+    {
+      g_containerable_add (container, child);
+      g_containerable_remove (container, child);
+    }
+  g_timer_stop (timer);
+  report ("GContainer add + remove",
+          g_timer_elapsed (timer, NULL), n_ops);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_ops; ++ n)
+    {
+      g_containerable_add_unchecked (container, child);
+      g_containerable_remove_unchecked (container, child);
+    }
+  g_timer_stop (timer);
+  report ("GContainer add + remove, unchecked",
+          g_timer_elapsed (timer, NULL), n_ops);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_ops; ++ n)
+    {
+      g_containerable_add (bin, child);
+      g_containerable_remove (bin, child);
+    }
+  g_timer_stop (timer);
+  report ("GBin add + remove",
+          g_timer_elapsed (timer, NULL), n_ops);
+
+  g_containerable_add (container, child);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_ops; ++ n)
+    parent = g_childable_get_parent (child);
+  g_timer_stop (timer);
+  report ("GChild get_parent",
+          g_timer_elapsed (timer, NULL), n_ops);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_ops; ++ n)
+    parent = g_childable_get_parent_unchecked (child);
+  g_timer_stop (timer);
+  report ("GChild get_parent, unchecked",
+          g_timer_elapsed (timer, NULL), n_ops);
+
+  g_assert (parent == container);
+
+  /* Children of different types, as in any real tree: the interface
+   * lookup sees a different instance type on every call */
+  {
+    GChildable *mixed[3];
+
+    mixed[0] = child;
+    mixed[1] = G_CHILDABLE (g_object_ref_sink (g_container_new ()));
+    mixed[2] = G_CHILDABLE (g_object_ref_sink (g_bin_new ()));
+    g_containerable_add (container, mixed[1]);
+    g_containerable_add (container, mixed[2]);
+
+    g_timer_start (timer);
+    for (n = 0; n < n_ops; ++ n)
+      parent = g_childable_get_parent (mixed[n % 3]);
+    g_timer_stop (timer);
+    report ("GChild/GContainer/GBin get_parent, alternated",
+            g_timer_elapsed (timer, NULL), n_ops);
+
+    g_assert (parent == container);
+    g_object_unref (mixed[1]);
+    g_object_unref (mixed[2]);
+  }
+
+  g_timer_destroy (timer);
+  g_object_unref (child);
+  g_object_unref (bin);
+  g_object_unref (container);
+}
+
+
+
+/* Instance pools: creating and releasing short-lived children and
+ * containers, with and without recycling */
+
+static void
+create_and_release (const gchar *what,
+                    GObject   *(*constructor) (void),
+                    guint        n_ops)
+{
+  GTimer *timer;
+  guint   n;
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_ops; ++ n)
+    g_object_unref (g_object_ref_sink (constructor ()));
+  g_timer_stop (timer);
+  report (what, g_timer_elapsed (timer, NULL), n_ops);
+
+  g_timer_destroy (timer);
+}
+
+static void
+bench_pool (void)
+{
+  const guint        n_ops = 1000000;
+  GInstancePoolStats stats;
+
+  create_and_release ("GChild new + unref", g_child_new, n_ops);
+  create_and_release ("GContainer new + unref", g_container_new, n_ops);
+
+  g_child_set_pool_limit (64);
+  g_container_set_pool_limit (64);
+
+  create_and_release ("GChild new + unref, pooled", g_child_new, n_ops);
+  create_and_release ("GContainer new + unref, pooled", g_container_new, n_ops);
+
+  g_child_get_pool_stats (&stats);
+  g_assert (stats.n_reused == n_ops - 1);
+
+  g_child_set_pool_limit (0);
+  g_container_set_pool_limit (0);
+}
+
+
+/* Concurrent access: reader threads iterate on a shared container and
+ * query the parent of a child while a writer keeps adding and removing
+ * another child. The thread safe mode is compared with the whole tree
+ * serialized behind a global mutex */
+
+typedef struct
+{
+  GContainerable *container;
+  GChildable     *probe;
+  GChildable     *spare;
+  GMutex         *mutex;
+  gint            stop;
+  gint            n_reads;
+} ThreadsData;
+
+static void
+count_child (GObject *child,
+             guint   *counter)
+{
+  ++ *counter;
+}
+
+static gpointer
+reader_thread (ThreadsData *data)
+{
+  guint n_reads, counter;
+
+  n_reads = 0;
+  counter = 0;
+
+  while (! g_atomic_int_get (&data->stop))
+    {
+      if (data->mutex)
+        g_mutex_lock (data->mutex);
+
+      g_containerable_foreach (data->container,
+                               G_CALLBACK (count_child), &counter);
+      g_assert (g_childable_get_parent (data->probe) == data->container);
+
+      if (data->mutex)
+        g_mutex_unlock (data->mutex);
+
+      ++ n_reads;
+    }
+
+  g_atomic_int_add (&data->n_reads, n_reads);
+  return NULL;
+}
+
+static gpointer
+writer_thread (ThreadsData *data)
+{
+  while (! g_atomic_int_get (&data->stop))
+    {
+      if (data->mutex)
+        g_mutex_lock (data->mutex);
+
+      g_containerable_add (data->container, data->spare);
+      g_containerable_remove (data->container, data->spare);
+
+      if (data->mutex)
+        g_mutex_unlock (data->mutex);
+
+      g_usleep (100);
+    }
+
+  return NULL;
+}
+
+static void
+run_threads (const gchar    *what,
+             GContainerable *container,
+             GMutex         *mutex,
+             guint           n_readers)
+{
+  const gdouble seconds = 0.5;
+  ThreadsData   data;
+  GThread     **readers;
+  GThread      *writer;
+  GObject      *probe, *spare;
+  gchar        *label;
+  guint         n;
+
+  probe = g_child_new ();
+  g_containerable_add (container, G_CHILDABLE (probe));
+  spare = g_object_ref_sink (g_child_new ());
+
+  data.container = container;
+  data.probe = G_CHILDABLE (probe);
+  data.spare = G_CHILDABLE (spare);
+  data.mutex = mutex;
+  data.stop = 0;
+  data.n_reads = 0;
+
+  readers = g_new (GThread *, n_readers);
+  for (n = 0; n < n_readers; ++ n)
+    readers[n] = g_thread_new ("reader", (GThreadFunc) reader_thread, &data);
+  writer = g_thread_new ("writer", (GThreadFunc) writer_thread, &data);
+
+  g_usleep (seconds * G_USEC_PER_SEC);
+  g_atomic_int_set (&data.stop, 1);
+
+  for (n = 0; n < n_readers; ++ n)
+    g_thread_join (readers[n]);
+  g_thread_join (writer);
+
+  label = g_strdup_printf ("%s, %u readers", what, n_readers);
+  report (label, seconds, data.n_reads);
+
+  g_free (label);
+  g_free (readers);
+  g_object_unref (spare);
+  g_containerable_remove (container, G_CHILDABLE (probe));
+}
+
+static void
+bench_threads (void)
+{
+  const guint     n_children = 100;
+  GContainerable *shared, *safe;
+  GMutex          mutex;
+  guint           n, n_processors;
+
+  g_mutex_init (&mutex);
+  shared = g_object_ref_sink (g_container_new ());
+  safe = g_object_ref_sink (g_object_new (G_TYPE_CONTAINER,
+                                          "thread-safe", TRUE, NULL));
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      g_containerable_add (shared, G_CHILDABLE (g_child_new ()));
+      g_containerable_add (safe, G_CHILDABLE (g_child_new ()));
+    }
+
+  n_processors = g_get_num_processors ();
+
+  for (n = 1; n <= n_processors; n *= 2)
+    {
+      run_threads ("global mutex", shared, &mutex, n);
+      run_threads ("thread-safe container", safe, NULL, n);
+    }
+
+  g_object_unref (safe);
+  g_object_unref (shared);
+  g_mutex_clear (&mutex);
+}
+
+
+/* Children snapshots: reading the children of a container that does not
+ * change, compared with the list copied by g_containerable_get_children() */
+
+static void
+bench_snapshot (void)
+{
+  const guint     n_children = 1000;
+  const guint     n_rounds = 100000;
+  GContainerable *container;
+  GSList         *children;
+  GPtrArray      *snapshot;
+  guint           n;
+  GTimer         *timer;
+
+  container = g_object_ref_sink (g_container_new ());
+  for (n = 0; n < n_children; ++ n)
+    g_containerable_add (container, G_CHILDABLE (g_child_new ()));
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds / 100; ++ n)
+    g_slist_free (g_containerable_get_children (container));
+  g_timer_stop (timer);
+  report ("g_containerable_get_children(), 1000 children",
+          g_timer_elapsed (timer, NULL), n_rounds / 100);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_ptr_array_unref (g_containerable_get_children_snapshot (container));
+  g_timer_stop (timer);
+  report ("g_containerable_get_children_snapshot()",
+          g_timer_elapsed (timer, NULL), n_rounds);
+
+  /* A snapshot survives the changes of the container */
+  snapshot = g_containerable_get_children_snapshot (container);
+  children = g_containerable_get_children (container);
+  g_containerable_remove (container, children->data);
+  g_assert (snapshot->len == n_children);
+  g_ptr_array_unref (snapshot);
+  g_slist_free (children);
+
+  g_timer_destroy (timer);
+  g_object_unref (container);
+}
+
+
+/* Concurrent producers: more threads appending children to the same
+ * container, a GContainer behind a mutex against a GCollector */
+
+typedef struct
+{
+  GContainerable *container;
+  GMutex         *mutex;
+  guint           n_children;
+} ProducerData;
+
+static gpointer
+producer_thread (ProducerData *data)
+{
+  GObject *child;
+  guint    n;
+
+  for (n = 0; n < data->n_children; ++ n)
+    {
+      child = g_child_new ();
+
+      if (data->mutex)
+        g_mutex_lock (data->mutex);
+
+      g_containerable_add (data->container, G_CHILDABLE (child));
+
+      if (data->mutex)
+        g_mutex_unlock (data->mutex);
+    }
+
+  return NULL;
+}
+
+static void
+run_producers (const gchar    *what,
+               GContainerable *container,
+               GMutex         *mutex,
+               guint           n_producers)
+{
+  const guint   n_children = 200000;
+  ProducerData  data;
+  GThread     **producers;
+  GTimer       *timer;
+  gchar        *label;
+  guint         n;
+
+  data.container = container;
+  data.mutex = mutex;
+  data.n_children = n_children / n_producers;
+
+  producers = g_new (GThread *, n_producers);
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_producers; ++ n)
+    producers[n] = g_thread_new ("producer", (GThreadFunc) producer_thread, &data);
+  for (n = 0; n < n_producers; ++ n)
+    g_thread_join (producers[n]);
+  g_timer_stop (timer);
+
+  label = g_strdup_printf ("%s, %u producers", what, n_producers);
+  report (label, g_timer_elapsed (timer, NULL), data.n_children * n_producers);
+
+  g_free (label);
+  g_timer_destroy (timer);
+  g_free (producers);
+}
+
+static void
+bench_collector (void)
+{
+  GContainerable *container;
+  GMutex          mutex;
+  GPtrArray      *children;
+  guint           n, n_processors;
+
+  g_mutex_init (&mutex);
+  n_processors = MAX (g_get_num_processors (), 4);
+
+  for (n = 1; n <= n_processors; n *= 2)
+    {
+      container = g_object_ref_sink (g_container_new ());
+      run_producers ("GContainer, global mutex", container, &mutex, n);
+      g_object_unref (container);
+
+      container = g_object_ref_sink (g_collector_new ());
+      run_producers ("GCollector", container, NULL, n);
+      children = g_collector_take_all (G_COLLECTOR (container));
+      g_assert (children->len == 200000 / n * n);
+      g_ptr_array_unref (children);
+      g_object_unref (container);
+    }
+
+  g_mutex_clear (&mutex);
+}
+
+/* Size, membership and position queries, compared with the same
+ * answers computed on the list copied by g_containerable_get_children() */
+
+static void
+bench_queries (void)
+{
+  const guint     n_children = 1000;
+  const guint     n_rounds = 100000;
+  GContainerable *container;
+  GChildable     *last;
+  GSList         *children;
+  guint           n, length;
+  gboolean        found;
+  GTimer         *timer;
+
+  container = g_object_ref_sink (g_container_new ());
+  for (n = 0; n < n_children; ++ n)
+    g_containerable_add (container, G_CHILDABLE (g_child_new ()));
+
+  last = g_containerable_get_nth (container, n_children - 1);
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds / 100; ++ n)
+    {
+      children = g_containerable_get_children (container);
+      length = g_slist_length (children);
+      found = g_slist_find (children, last) != NULL;
+      g_slist_free (children);
+    }
+  g_timer_stop (timer);
+  g_assert (length == n_children && found);
+  report ("size and membership from get_children()",
+          g_timer_elapsed (timer, NULL), n_rounds / 100);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    {
+      length = g_containerable_n_children (container);
+      found = g_containerable_contains (container, last);
+    }
+  g_timer_stop (timer);
+  g_assert (length == n_children && found);
+  report ("g_containerable_n_children() + contains()",
+          g_timer_elapsed (timer, NULL), n_rounds);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_assert (g_containerable_get_nth (container, n % n_children) != NULL);
+  g_timer_stop (timer);
+  report ("g_containerable_get_nth()",
+          g_timer_elapsed (timer, NULL), n_rounds);
+
+  g_assert (g_containerable_get_nth (container, n_children) == NULL);
+
+  g_timer_destroy (timer);
+  g_object_unref (container);
+}
+
+/* Positional container: inserting, indexing and removing in the middle
+ * of a GSlot must scale logarithmically with the number of children */
+
+static void
+bench_slot (void)
+{
+  const guint     n_ops = 10000;
+  GSlot          *slot;
+  GObject       **children;
+  gchar          *what;
+  guint           n, n_children;
+  GTimer         *timer;
+
+  timer = g_timer_new ();
+  children = g_new (GObject *, n_ops);
+
+  for (n = 0; n < n_ops; ++ n)
+    children[n] = g_object_ref_sink (g_child_new ());
+
+  for (n_children = 1000; n_children <= 100000; n_children *= 10)
+    {
+      slot = g_object_ref_sink (g_slot_new ());
+      for (n = 0; n < n_children; ++ n)
+        g_containerable_add ((GContainerable *) slot, G_CHILDABLE (g_child_new ()));
+
+      what = g_strdup_printf ("g_slot_insert() in the middle, %u children", n_children);
+      g_timer_start (timer);
+      for (n = 0; n < n_ops; ++ n)
+        g_slot_insert (slot, G_CHILDABLE (children[n]), (n_children + n) / 2);
+      g_timer_stop (timer);
+      report (what, g_timer_elapsed (timer, NULL), n_ops);
+      g_free (what);
+
+      g_timer_start (timer);
+      for (n = 0; n < n_ops; ++ n)
+        g_assert (g_containerable_get_nth ((GContainerable *) slot,
+                                           n * 7919 % n_children) != NULL);
+      g_timer_stop (timer);
+      report ("g_containerable_get_nth() at random",
+              g_timer_elapsed (timer, NULL), n_ops);
+
+      g_timer_start (timer);
+      for (n = 0; n < n_ops; ++ n)
+        g_assert (g_slot_get_position (slot, G_CHILDABLE (children[n])) >= 0);
+      g_timer_stop (timer);
+      report ("g_slot_get_position()",
+              g_timer_elapsed (timer, NULL), n_ops);
+
+      g_timer_start (timer);
+      for (n = 0; n < n_ops; ++ n)
+        g_slot_remove_nth (slot, (n_children + n_ops - n) / 2);
+      g_timer_stop (timer);
+      report ("g_slot_remove_nth() in the middle",
+              g_timer_elapsed (timer, NULL), n_ops);
+
+      g_assert (g_containerable_n_children ((GContainerable *) slot) == n_children);
+      g_object_unref (slot);
+    }
+
+  for (n = 0; n < n_ops; ++ n)
+    g_object_unref (children[n]);
+
+  g_free (children);
+  g_timer_destroy (timer);
+}
+
+/* Lookup by key: the key of every child is stored in its object data,
+ * searched with a foreach on a GContainer or indexed by a GKeyedContainer */
+
+typedef struct
+{
+  const gchar *key;
+  GChildable  *found;
+} KeyedData;
+
+static gchar *
+child_key (GChildable *childable,
+           gpointer    user_data)
+{
+  return g_strdup (g_object_get_data ((GObject *) childable, "key"));
+}
+
+static void
+match_key (GChildable *childable,
+           KeyedData  *data)
+{
+  if (strcmp (g_object_get_data ((GObject *) childable, "key"), data->key) == 0)
+    data->found = childable;
+}
+
+static void
+bench_keyed (void)
+{
+  const guint      n_children = 1000;
+  const guint      n_rounds = 100000;
+  GContainerable  *container;
+  GKeyedContainer *keyed;
+  GObject         *child;
+  gchar          **keys;
+  KeyedData        data;
+  guint            n;
+  GTimer          *timer;
+
+  container = g_object_ref_sink (g_container_new ());
+  keyed = g_object_ref_sink (g_keyed_container_new_with_func (child_key, NULL, NULL));
+  keys = g_new0 (gchar *, n_children + 1);
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      keys[n] = g_strdup_printf ("child%u", n);
+
+      child = g_child_new ();
+      g_object_set_data ((GObject *) child, "key", keys[n]);
+      g_containerable_add (container, G_CHILDABLE (child));
+
+      child = g_child_new ();
+      g_object_set_data ((GObject *) child, "key", keys[n]);
+      g_containerable_add ((GContainerable *) keyed, G_CHILDABLE (child));
+    }
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds / 100; ++ n)
+    {
+      data.key = keys[n * 7919 % n_children];
+      data.found = NULL;
+      g_containerable_foreach (container, G_CALLBACK (match_key), &data);
+      g_assert (data.found != NULL);
+    }
+  g_timer_stop (timer);
+  report ("foreach on GContainer, 1000 children",
+          g_timer_elapsed (timer, NULL), n_rounds / 100);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_assert (g_keyed_container_lookup (keyed, keys[n * 7919 % n_children]) != NULL);
+  g_timer_stop (timer);
+  report ("g_keyed_container_lookup()",
+          g_timer_elapsed (timer, NULL), n_rounds);
+
+  g_timer_destroy (timer);
+  g_object_unref (keyed);
+  g_object_unref (container);
+  g_strfreev (keys);
+}
+
+/* Sorted reads: sorting a copy of the children of a GContainer on every
+ * read, against a GSortedContainer that keeps them sorted. The rank of
+ * every child is stored in its object data. */
+
+static gint
+rank_of (gconstpointer childable)
+{
+  return GPOINTER_TO_INT (g_object_get_data ((GObject *) childable, "rank"));
+}
+
+static gint
+compare_rank (gconstpointer a,
+              gconstpointer b,
+              gpointer      user_data)
+{
+  return rank_of (a) - rank_of (b);
+}
+
+static gint
+compare_rank_key (gconstpointer childable,
+                  gconstpointer key,
+                  gpointer      user_data)
+{
+  return rank_of (childable) - GPOINTER_TO_INT (key);
+}
+
+static void
+bench_sorted (void)
+{
+  const guint       n_children = 1000;
+  const guint       n_rounds = 100000;
+  GContainerable   *container;
+  GSortedContainer *sorted;
+  GObject          *child;
+  GSList           *children;
+  guint             n, rank;
+  GTimer           *timer;
+
+  container = g_object_ref_sink (g_container_new ());
+  sorted = g_object_ref_sink (g_sorted_container_new (NULL, compare_rank, NULL, NULL));
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      rank = n * 7919 % n_children;
+
+      child = g_child_new ();
+      g_object_set_data (child, "rank", GUINT_TO_POINTER (rank));
+      g_containerable_add (container, G_CHILDABLE (child));
+
+      child = g_child_new ();
+      g_object_set_data (child, "rank", GUINT_TO_POINTER (rank));
+      g_containerable_add ((GContainerable *) sorted, G_CHILDABLE (child));
+    }
+
+  timer = g_timer_new ();
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds / 100; ++ n)
+    {
+      children = g_containerable_get_children (container);
+      children = g_slist_sort_with_data (children, compare_rank, NULL);
+      g_slist_free (children);
+    }
+  g_timer_stop (timer);
+  report ("sorted copy of a GContainer, 1000 children",
+          g_timer_elapsed (timer, NULL), n_rounds / 100);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds / 100; ++ n)
+    g_slist_free (g_containerable_get_children ((GContainerable *) sorted));
+  g_timer_stop (timer);
+  report ("children of a GSortedContainer",
+          g_timer_elapsed (timer, NULL), n_rounds / 100);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    g_assert (g_sorted_container_find (sorted, GUINT_TO_POINTER (n % n_children),
+                                       compare_rank_key, NULL) != NULL);
+  g_timer_stop (timer);
+  report ("g_sorted_container_find()",
+          g_timer_elapsed (timer, NULL), n_rounds);
+
+  g_timer_destroy (timer);
+  g_object_unref (sorted);
+  g_object_unref (container);
+}
+
+/* Iteration on large containers: the list nodes of GContainer against
+ * the arrays of GChunkedContainer, both just filled and after removing
+ * and adding back the children in random order, that scatters the list
+ * nodes across the heap */
+
+static void
+run_iteration (const gchar    *what,
+               GContainerable *container,
+               GChildable    **children,
+               guint           n_children)
+{
+  const guint  n_rounds = 100;
+  GRand       *rand;
+  gchar       *label;
+  guint        n, counter;
+  GTimer      *timer;
+
+  timer = g_timer_new ();
+
+  for (n = 0; n < n_children; ++ n)
+    g_containerable_add (container, children[n]);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    {
+      counter = 0;
+      g_containerable_foreach (container, G_CALLBACK (count_child), &counter);
+    }
+  g_timer_stop (timer);
+  g_assert (counter == n_children);
+  label = g_strdup_printf ("%s, filled", what);
+  report (label, g_timer_elapsed (timer, NULL), n_rounds * n_children);
+  g_free (label);
+
+  rand = g_rand_new_with_seed (n_children);
+  for (n = 0; n < n_children; ++ n)
+    {
+      GChildable *childable = children[g_rand_int_range (rand, 0, n_children)];
+
+      g_containerable_remove (container, childable);
+      g_containerable_add (container, childable);
+    }
+  g_rand_free (rand);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    {
+      counter = 0;
+      g_containerable_foreach (container, G_CALLBACK (count_child), &counter);
+    }
+  g_timer_stop (timer);
+  g_assert (counter == n_children);
+  label = g_strdup_printf ("%s, shuffled", what);
+  report (label, g_timer_elapsed (timer, NULL), n_rounds * n_children);
+  g_free (label);
+
+  g_timer_destroy (timer);
+}
+
+static void
+bench_iteration (void)
+{
+  const guint      n_children = 100000;
+  GContainerable  *container;
+  GChildable     **children;
+  guint            n;
+
+  children = g_new (GChildable *, n_children);
+  for (n = 0; n < n_children; ++ n)
+    children[n] = G_CHILDABLE (g_object_ref_sink (g_child_new ()));
+
+  container = g_object_ref_sink (g_container_new ());
+  run_iteration ("GContainer foreach, 100000 children",
+                 container, children, n_children);
+  g_object_unref (container);
+
+  container = g_object_ref_sink (g_chunked_container_new ());
+  run_iteration ("GChunkedContainer foreach",
+                 container, children, n_children);
+  g_object_unref (container);
+
+  for (n = 0; n < n_children; ++ n)
+    g_object_unref (children[n]);
+
+  g_free (children);
+}
+
+/* Pointer search: the vectorized kernel used on arrays of children
+ * against g_slist_find() on a list of the same pointers. The needle is
+ * the last element, so the whole sequence is scanned */
+
+static void
+bench_search (void)
+{
+  gconstpointer *pointers;
+  gconstpointer  needle;
+  GSList        *list;
+  gchar         *what;
+  guint          n, n_pointers, n_rounds;
+  GTimer        *timer;
+
+  g_print ("  (kernel: %s)\n", _g_pointer_search_impl ());
+  timer = g_timer_new ();
+
+  for (n_pointers = 1000; n_pointers <= 1000000; n_pointers *= 10)
+    {
+      pointers = g_new (gconstpointer, n_pointers);
+      list = NULL;
+
+      for (n = n_pointers; n --; )
+        {
+          pointers[n] = GUINT_TO_POINTER ((n + 1) * 16);
+          list = g_slist_prepend (list, (gpointer) pointers[n]);
+        }
+
+      needle = pointers[n_pointers - 1];
+      n_rounds = MAX (100000000 / n_pointers / 10, 10);
+
+      what = g_strdup_printf ("g_slist_find(), %u pointers", n_pointers);
+      g_timer_start (timer);
+      for (n = 0; n < n_rounds; ++ n)
+        g_assert (g_slist_find (list, needle) != NULL);
+      g_timer_stop (timer);
+      report (what, g_timer_elapsed (timer, NULL), n_rounds);
+      g_free (what);
+
+      g_timer_start (timer);
+      for (n = 0; n < n_rounds; ++ n)
+        g_assert (_g_pointer_search (pointers, n_pointers, needle) == (gint) n_pointers - 1);
+      g_timer_stop (timer);
+      report ("_g_pointer_search()", g_timer_elapsed (timer, NULL), n_rounds);
+
+      g_slist_free (list);
+      g_free (pointers);
+    }
+
+  g_timer_destroy (timer);
+}
+
+/* Children tracking: adding and removing children in the middle of a
+ * large container with a GContainerable::children-changed handler, so
+ * the position of the children must be reported, one at a time and in
+ * batches of two */
+
+static void
+children_changed_handler (GContainerable *containerable,
+                          guint           position,
+                          guint           removed,
+                          guint           added,
+                          gpointer        user_data)
+{
+  ++ *(guint *) user_data;
+}
+
+static void
+track_children (const gchar *name,
+                GObject     *container)
+{
+  const guint n_children = 10000;
+  const guint n_rounds = 1000;
+  GChildable *batch[2];
+  GObject    *child;
+  guint       n, counter;
+  GTimer     *timer;
+  gchar      *what;
+
+  g_object_ref_sink (container);
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      child = g_child_new ();
+      g_containerable_add ((GContainerable *) container, (GChildable *) child);
+
+      if (n == n_children / 4)
+        batch[0] = g_object_ref (child);
+      else if (n == n_children / 2)
+        batch[1] = g_object_ref (child);
+    }
+
+  counter = 0;
+  g_signal_connect (container, "children-changed",
+                    G_CALLBACK (children_changed_handler), &counter);
+
+  timer = g_timer_new ();
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    {
+      g_containerable_remove ((GContainerable *) container, batch[1]);
+      g_containerable_add ((GContainerable *) container, batch[1]);
+    }
+  g_timer_stop (timer);
+  what = g_strdup_printf ("%s remove + add, %u children", name, n_children);
+  report (what, g_timer_elapsed (timer, NULL), n_rounds * 2);
+  g_free (what);
+
+  g_assert (counter == n_rounds * 2);
+
+  g_timer_start (timer);
+  for (n = 0; n < n_rounds; ++ n)
+    {
+      g_containerable_remove_many ((GContainerable *) container, 2, batch,
+                                   G_CONTAINERABLE_EMIT_BATCH);
+      g_containerable_add_many ((GContainerable *) container, 2, batch,
+                                G_CONTAINERABLE_EMIT_BATCH);
+    }
+  g_timer_stop (timer);
+  what = g_strdup_printf ("%s batch remove + add", name);
+  report (what, g_timer_elapsed (timer, NULL), n_rounds * 2);
+  g_free (what);
+
+  g_assert (counter == n_rounds * 4);
+
+  g_timer_destroy (timer);
+  g_object_unref (batch[0]);
+  g_object_unref (batch[1]);
+  g_object_unref (container);
+}
+
+static gint
+compare_pointers (gconstpointer a,
+                  gconstpointer b,
+                  gpointer      user_data)
+{
+  return a < b ? -1 : a > b;
+}
+
+static void
+bench_tracking (void)
+{
+  track_children ("GContainer", g_container_new ());
+  track_children ("GSlot", g_slot_new ());
+  track_children ("GSortedContainer",
+                  g_sorted_container_new (NULL, compare_pointers, NULL, NULL));
+  track_children ("GChunkedContainer", g_chunked_container_new ());
+}
+
+int
+main (int argc, char *argv[])
+{
+  guint n;
+  gint  i;
+
+  g_type_init ();
+
+  for (n = 0; n < G_N_ELEMENTS (benchs); ++ n)
+    {
+      if (argc > 1)
+        {
+          for (i = 1; i < argc; ++ i)
+            if (strcmp (argv[i], benchs[n].name) == 0)
+              break;
+
+          if (i == argc)
+            continue;
+        }
+
+      g_print ("%s:\n", benchs[n].name);
+      benchs[n].func ();
+    }
+
+  return 0;
+}
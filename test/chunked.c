@@ -0,0 +1,228 @@
+/* libgcontainer - GChunkedContainer test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * GChunkedContainer compaction: children removed while iterating leave
+ * holes in their chunks, that must be skipped by any query during the
+ * iteration and compacted away when the outermost iteration ends, with
+ * the surviving children in their original order.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+/* Private header, not installed: used to check the chunks themselves */
+#include <gcontainer/gchunkedcontainerprivate.h>
+
+
+#define N_CHILDREN	300
+
+
+typedef struct
+{
+  GContainerable *containerable;
+  guint           n_visited;
+  guint           n_nested;
+} Visit;
+
+
+/* Checks that @chunked_container holds the children in @expected, in
+ * this order, in chunks without holes that cannot be merged anymore */
+static void
+check_compacted (GChunkedContainer *chunked_container,
+                 GPtrArray         *expected)
+{
+  GChunk *chunk;
+  guint   n, index;
+
+  g_assert (! chunked_container->priv->has_holes);
+  g_assert (chunked_container->priv->n_children == expected->len);
+  g_assert (g_containerable_n_children ((GContainerable *) chunked_container) ==
+            expected->len);
+
+  index = 0;
+
+  for (chunk = chunked_container->priv->head; chunk; chunk = chunk->next)
+    {
+      g_assert (chunk->len > 0);
+
+      if (chunk->next != NULL)
+        g_assert (chunk->len + chunk->next->len > G_CHUNK_SIZE);
+      else
+        g_assert (chunk == chunked_container->priv->tail);
+
+      for (n = 0; n < chunk->len; ++ n)
+        g_assert (chunk->children[n] == g_ptr_array_index (expected, index ++));
+    }
+
+  g_assert (index == expected->len);
+
+  if (expected->len == 0)
+    g_assert (chunked_container->priv->head == NULL &&
+              chunked_container->priv->tail == NULL);
+}
+
+/* Removes two children out of three, including the current one */
+static void
+remove_some (GChildable *childable,
+             Visit      *visit)
+{
+  if (visit->n_visited ++ % 3 != 0)
+    g_containerable_remove (visit->containerable, childable);
+}
+
+static void
+remove_all (GChildable *childable,
+            Visit      *visit)
+{
+  ++ visit->n_visited;
+  g_containerable_remove (visit->containerable, childable);
+}
+
+/* Removes the children from a nested iteration: the holes must survive
+ * until the outer iteration ends, and queries must skip them */
+static void
+remove_nested (GChildable *childable,
+               Visit      *visit)
+{
+  GChunkedContainer *chunked_container;
+  Visit              inner;
+
+  chunked_container = (GChunkedContainer *) visit->containerable;
+
+  if (visit->n_visited ++ != 0)
+    return;
+
+  inner.containerable = visit->containerable;
+  inner.n_visited = 0;
+  g_containerable_foreach (visit->containerable, G_CALLBACK (remove_some), &inner);
+
+  g_assert (chunked_container->priv->iterating == 1);
+  g_assert (chunked_container->priv->has_holes);
+  visit->n_nested = inner.n_visited;
+
+  /* Only the first child of every three is left, starting from this */
+  g_assert (g_containerable_get_nth (visit->containerable, 0) == childable);
+  g_assert (g_containerable_n_children (visit->containerable) ==
+            (inner.n_visited + 2) / 3);
+}
+
+static void
+fill (GChunkedContainer *chunked_container,
+      GChildable       **children,
+      GPtrArray         *expected)
+{
+  guint n;
+
+  g_ptr_array_set_size (expected, 0);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      g_containerable_add ((GContainerable *) chunked_container, children[n]);
+      g_ptr_array_add (expected, children[n]);
+    }
+
+  check_compacted (chunked_container, expected);
+}
+
+static void
+keep_one_of_three (GPtrArray *expected)
+{
+  guint n;
+
+  for (n = expected->len; n --; )
+    if (n % 3 != 0)
+      g_ptr_array_remove_index (expected, n);
+}
+
+int
+main (int argc, char *argv[])
+{
+  GChunkedContainer *chunked_container;
+  GContainerable    *containerable;
+  GChildable        *children[N_CHILDREN];
+  GPtrArray         *expected;
+  Visit              visit;
+  guint              n;
+
+  g_type_init ();
+
+  chunked_container = g_object_ref_sink (g_chunked_container_new ());
+  containerable = (GContainerable *) chunked_container;
+  expected = g_ptr_array_new ();
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    children[n] = g_object_ref_sink (g_child_new ());
+
+  /* Removing while iterating: every child is still visited once */
+  fill (chunked_container, children, expected);
+  visit.containerable = containerable;
+  visit.n_visited = 0;
+  g_containerable_foreach (containerable, G_CALLBACK (remove_some), &visit);
+  g_assert (visit.n_visited == N_CHILDREN);
+  keep_one_of_three (expected);
+  check_compacted (chunked_container, expected);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    if (n % 3 != 0)
+      {
+        g_assert (g_childable_get_parent (children[n]) == NULL);
+        g_assert (G_OBJECT (children[n])->ref_count == 1);
+      }
+
+  /* Removing outside an iteration merges the chunks left too small */
+  while (expected->len > 0)
+    {
+      n = expected->len / 2;
+      g_containerable_remove (containerable, g_ptr_array_index (expected, n));
+      g_ptr_array_remove_index (expected, n);
+      check_compacted (chunked_container, expected);
+    }
+
+  /* Emptying the container while iterating frees every chunk */
+  fill (chunked_container, children, expected);
+  visit.n_visited = 0;
+  g_containerable_foreach (containerable, G_CALLBACK (remove_all), &visit);
+  g_assert (visit.n_visited == N_CHILDREN);
+  g_ptr_array_set_size (expected, 0);
+  check_compacted (chunked_container, expected);
+
+  /* Nested iterations compact only at the end of the outer one */
+  fill (chunked_container, children, expected);
+  visit.n_visited = 0;
+  g_containerable_foreach (containerable, G_CALLBACK (remove_nested), &visit);
+  g_assert (visit.n_nested == N_CHILDREN);
+  g_assert (visit.n_visited == (N_CHILDREN + 2) / 3);
+  keep_one_of_three (expected);
+  check_compacted (chunked_container, expected);
+
+  g_object_unref (chunked_container);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      g_assert (g_childable_get_parent (children[n]) == NULL);
+      g_assert (G_OBJECT (children[n])->ref_count == 1);
+      g_object_unref (children[n]);
+    }
+
+  g_ptr_array_free (expected, TRUE);
+
+  return 0;
+}
@@ -43,6 +43,18 @@ static void     containerable_add       (GContainerable *containerable,
                                          GChildable     *childable);
 static void     containerable_remove    (GContainerable *containerable,
                                          GChildable     *childable);
+static void     containerable_add_many  (GContainerable *containerable,
+                                         guint           n_children,
+                                         GChildable    **children);
+static void     containerable_remove_many
+                                        (GContainerable *containerable,
+                                         guint           n_children,
+                                         GChildable    **children);
+static void     containerable_children_changed
+                                        (GContainerable *containerable,
+                                         guint           position,
+                                         guint           removed,
+                                         guint           added);
 static void     containerable_destroy   (gchar          *name);
 static void     childable_parent_set    (GChildable     *childable,
                                          GContainerable *old_parent);
@@ -65,6 +77,38 @@ containerable_remove (GContainerable *containerable,
   DEBUG_OBJECT (childable, "removed from '%s'", NAME (containerable));
 }
 
+static void
+containerable_add_many (GContainerable *containerable,
+                        guint           n_children,
+                        GChildable    **children)
+{
+  guint n;
+
+  for (n = 0; n < n_children; ++ n)
+    DEBUG_OBJECT (children[n], "added to '%s' in a batch", NAME (containerable));
+}
+
+static void
+containerable_remove_many (GContainerable *containerable,
+                           guint           n_children,
+                           GChildable    **children)
+{
+  guint n;
+
+  for (n = 0; n < n_children; ++ n)
+    DEBUG_OBJECT (children[n], "removed from '%s' in a batch", NAME (containerable));
+}
+
+static void
+containerable_children_changed (GContainerable *containerable,
+                                guint           position,
+                                guint           removed,
+                                guint           added)
+{
+  DEBUG_OBJECT (containerable, "changed %u children at %u with %u new ones",
+                removed, position, added);
+}
+
 static void
 containerable_destroy (gchar *name)
 {
@@ -136,6 +180,9 @@ new_container (const gchar *name)
 
   g_signal_connect (container, "add", G_CALLBACK (containerable_add), NULL);
   g_signal_connect (container, "remove", G_CALLBACK (containerable_remove), NULL);
+  g_signal_connect (container, "add-many", G_CALLBACK (containerable_add_many), NULL);
+  g_signal_connect (container, "remove-many", G_CALLBACK (containerable_remove_many), NULL);
+  g_signal_connect (container, "children-changed", G_CALLBACK (containerable_children_changed), NULL);
   g_signal_connect (container, "parent-set", G_CALLBACK (childable_parent_set), NULL);
 
   /* There's no "destroy" or "dispose" signals, so I add a weak
@@ -160,6 +207,9 @@ new_bin (const gchar *name)
 
   g_signal_connect (bin, "add", G_CALLBACK (containerable_add), NULL);
   g_signal_connect (bin, "remove", G_CALLBACK (containerable_remove), NULL);
+  g_signal_connect (bin, "add-many", G_CALLBACK (containerable_add_many), NULL);
+  g_signal_connect (bin, "remove-many", G_CALLBACK (containerable_remove_many), NULL);
+  g_signal_connect (bin, "children-changed", G_CALLBACK (containerable_children_changed), NULL);
   g_signal_connect (bin, "parent-set", G_CALLBACK (childable_parent_set), NULL);
 
   g_object_weak_ref (bin, (GWeakNotify) containerable_destroy, (gpointer) name);
@@ -27,7 +27,8 @@ main (int argc, char *argv[])
   GObject *container;
   GObject *bin;
   GObject *self_container;
-  GObject *child1, *child2, *child3, *child4;
+  GObject *child1, *child2, *child3, *child4, *child8;
+  GChildable *batch[2];
   
   g_print ("Initializing the type system...\n");
   g_type_init ();
@@ -80,6 +81,27 @@ main (int argc, char *argv[])
   show_containerable (G_CONTAINERABLE (container));
   show_containerable (G_CONTAINERABLE (bin));
 
+  g_print ("\nAdding 'child5' and 'child6' to 'container' in a single batch...\n");
+  batch[0] = G_CHILDABLE (new_child ("child5"));
+  batch[1] = G_CHILDABLE (new_child ("child6"));
+  g_containerable_add_many (G_CONTAINERABLE (container), 2, batch,
+                            G_CONTAINERABLE_EMIT_BATCH);
+  show_containerable (G_CONTAINERABLE (container));
+
+  g_print ("\nRemoving 'child5' and 'child6' from 'container' in a single batch...\n");
+  g_containerable_remove_many (G_CONTAINERABLE (container), 2, batch,
+                               G_CONTAINERABLE_EMIT_BATCH);
+  show_containerable (G_CONTAINERABLE (container));
+
+  g_print ("\nAdding 'child7' and 'child8' and removing 'child8' from 'container'\n"
+           "with frozen notifications: only one 'children-changed' is emitted...\n");
+  g_containerable_freeze_children_notify (G_CONTAINERABLE (container));
+  g_containerable_add (G_CONTAINERABLE (container), G_CHILDABLE (new_child ("child7")));
+  g_containerable_add (G_CONTAINERABLE (container), G_CHILDABLE (child8 = new_child ("child8")));
+  g_containerable_remove (G_CONTAINERABLE (container), G_CHILDABLE (child8));
+  g_containerable_thaw_children_notify (G_CONTAINERABLE (container));
+  show_containerable (G_CONTAINERABLE (container));
+
   g_print ("\nAdding 'container' inside 'bin'...\n"
            "The GContainer itsself implements GChildable.\n");
   g_containerable_add (G_CONTAINERABLE (bin), G_CHILDABLE (container));
@@ -0,0 +1,182 @@
+/* libgcontainer - Asynchronous dispose test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * Asynchronous dispose: the children must be detached at once but
+ * released from an idle source, never more than chunk_size objects per
+ * iteration, with a coherent progress report and a single completion
+ * notification, also when the source is destroyed before the end.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_BRANCHES	10
+#define N_LEAVES	20
+#define N_OBJECTS	(N_BRANCHES * (N_LEAVES + 1))
+#define CHUNK_SIZE	16
+
+
+typedef struct
+{
+  guint chunk_size;
+  guint n_finalized;
+  guint n_disposed;
+  guint n_pending;
+  guint n_progress;
+  guint n_notify;
+} Job;
+
+
+static void
+count_finalized (Job     *job,
+                 GObject *where_the_object_was)
+{
+  ++ job->n_finalized;
+}
+
+static void
+progress (guint n_disposed,
+          guint n_pending,
+          Job  *job)
+{
+  g_assert (job->n_notify == 0);
+  g_assert (n_disposed > job->n_disposed);
+  g_assert (n_disposed - job->n_disposed <= job->chunk_size);
+
+  /* Every released object has been finalized: the pool is disabled */
+  g_assert (n_disposed == job->n_finalized);
+
+  job->n_disposed = n_disposed;
+  job->n_pending = n_pending;
+  ++ job->n_progress;
+}
+
+static void
+notify (Job *job)
+{
+  ++ job->n_notify;
+}
+
+/* Builds a container with N_BRANCHES containers of N_LEAVES children,
+ * holding no other reference than the one of their parent */
+static GContainerable *
+new_tree (Job *job)
+{
+  GObject *root, *branch, *leaf;
+  guint    n, i;
+
+  root = g_object_ref_sink (g_container_new ());
+
+  for (n = 0; n < N_BRANCHES; ++ n)
+    {
+      branch = g_container_new ();
+      g_object_weak_ref (branch, (GWeakNotify) count_finalized, job);
+      g_containerable_add ((GContainerable *) root, (GChildable *) branch);
+
+      for (i = 0; i < N_LEAVES; ++ i)
+        {
+          leaf = g_child_new ();
+          g_object_weak_ref (leaf, (GWeakNotify) count_finalized, job);
+          g_containerable_add ((GContainerable *) branch, (GChildable *) leaf);
+        }
+    }
+
+  return (GContainerable *) root;
+}
+
+static void
+init_job (Job *job)
+{
+  job->chunk_size = CHUNK_SIZE;
+  job->n_finalized = 0;
+  job->n_disposed = 0;
+  job->n_pending = 0;
+  job->n_progress = 0;
+  job->n_notify = 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  GMainContext   *context;
+  GContainerable *root;
+  GObject        *child;
+  Job             job;
+  guint           id, n_finalized;
+
+  g_type_init ();
+
+  context = g_main_context_new ();
+
+  /* Released chunk by chunk, until completion */
+  init_job (&job);
+  root = new_tree (&job);
+  id = g_containerable_dispose_async (root, context, CHUNK_SIZE,
+                                      (GContainerableProgressFunc) progress,
+                                      &job, (GDestroyNotify) notify);
+  g_assert (id != 0);
+
+  /* The children are detached at once, but nothing is released yet */
+  g_assert (g_containerable_n_children (root) == 0);
+  g_assert (job.n_finalized == 0 && job.n_progress == 0);
+
+  while (job.n_notify == 0)
+    {
+      n_finalized = job.n_finalized;
+      g_assert (g_main_context_iteration (context, FALSE));
+      g_assert (job.n_finalized - n_finalized <= CHUNK_SIZE);
+      g_assert (job.n_disposed + job.n_pending <= N_OBJECTS);
+    }
+
+  g_assert (job.n_notify == 1);
+  g_assert (job.n_pending == 0);
+  g_assert (job.n_disposed == N_OBJECTS && job.n_finalized == N_OBJECTS);
+  g_assert (job.n_progress >= N_OBJECTS / CHUNK_SIZE);
+  g_assert (g_main_context_find_source_by_id (context, id) == NULL);
+
+  /* The container is left empty and can be reused */
+  child = g_child_new ();
+  g_containerable_add (root, (GChildable *) child);
+  g_assert (g_containerable_get_nth (root, 0) == (GChildable *) child);
+  g_object_unref (root);
+
+  /* Destroying the source releases the pending objects at once */
+  init_job (&job);
+  root = new_tree (&job);
+  id = g_containerable_dispose_async (root, context, CHUNK_SIZE,
+                                      (GContainerableProgressFunc) progress,
+                                      &job, (GDestroyNotify) notify);
+  g_assert (g_main_context_iteration (context, FALSE));
+  g_assert (job.n_progress == 1 && job.n_disposed == CHUNK_SIZE);
+  g_assert (job.n_notify == 0);
+
+  job.chunk_size = G_MAXUINT;
+  g_source_destroy (g_main_context_find_source_by_id (context, id));
+  g_assert (job.n_notify == 1);
+  g_assert (job.n_pending == 0);
+  g_assert (job.n_finalized == N_OBJECTS);
+
+  g_object_unref (root);
+  g_main_context_unref (context);
+
+  return 0;
+}
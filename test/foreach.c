@@ -0,0 +1,278 @@
+/* libgcontainer - Foreach test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * Children removed while iterating: the foreach callback, the handlers
+ * of a propagated signal and the handlers run by dispose can remove any
+ * child, not only the current one, on every container type. A walk
+ * must never reach a child removed before being visited, except on
+ * thread safe containers that walk a snapshot keeping them alive.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_CHILDREN	8
+
+
+typedef struct
+{
+  GContainerable *container;
+  GChildable     *children[N_CHILDREN];
+  GChildable     *visited[N_CHILDREN * 2];
+  guint           n_visited;
+  guint           n_finalized;
+} Walk;
+
+
+static gchar *
+pointer_key (GChildable *childable,
+             gpointer    user_data)
+{
+  return g_strdup_printf ("%p", childable);
+}
+
+static gint
+compare_pointers (gconstpointer a,
+                  gconstpointer b,
+                  gpointer      user_data)
+{
+  return a < b ? -1 : a > b;
+}
+
+static GContainerable *
+new_container (guint kind)
+{
+  GObject *object;
+
+  switch (kind)
+    {
+    case 0:
+      object = g_container_new ();
+      break;
+    case 1:
+      object = g_object_new (G_TYPE_CONTAINER, "thread-safe", TRUE, NULL);
+      break;
+    case 2:
+      object = g_keyed_container_new_with_func (pointer_key, NULL, NULL);
+      break;
+    case 3:
+      object = g_slot_new ();
+      break;
+    case 4:
+      object = g_sorted_container_new (NULL, compare_pointers, NULL, NULL);
+      break;
+    default:
+      object = g_chunked_container_new ();
+    }
+
+  return g_object_ref_sink (object);
+}
+
+static void
+count_finalized (Walk    *walk,
+                 GObject *where_the_object_was)
+{
+  ++ walk->n_finalized;
+}
+
+/* Fills a new container of type @kind with children referenced only by
+ * the container, stored in @walk in the order the container keeps them */
+static void
+init_walk (Walk  *walk,
+           guint  kind)
+{
+  GObject *child;
+  guint    n;
+
+  walk->container = new_container (kind);
+  walk->n_visited = 0;
+  walk->n_finalized = 0;
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      child = g_child_new ();
+      g_object_weak_ref (child, (GWeakNotify) count_finalized, walk);
+      g_containerable_add (walk->container, (GChildable *) child);
+    }
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    walk->children[n] = g_containerable_get_nth (walk->container, n);
+}
+
+static void
+visit (Walk       *walk,
+       GChildable *childable)
+{
+  g_assert (walk->n_visited < G_N_ELEMENTS (walk->visited));
+  walk->visited[walk->n_visited ++] = childable;
+}
+
+static void
+remove_next (GChildable *childable,
+             Walk       *walk)
+{
+  visit (walk, childable);
+
+  if (childable == walk->children[4])
+    g_containerable_remove (walk->container, walk->children[5]);
+}
+
+/* children[0] removes the next and the last child, children[2] removes
+ * itself and the next one, children[4] starts a nested walk that
+ * removes children[5] */
+static void
+remove_siblings (GChildable *childable,
+                 Walk       *walk)
+{
+  Walk nested;
+
+  visit (walk, childable);
+
+  if (childable == walk->children[0])
+    {
+      g_containerable_remove (walk->container, walk->children[1]);
+      g_containerable_remove (walk->container, walk->children[N_CHILDREN - 1]);
+    }
+  else if (childable == walk->children[2])
+    {
+      g_containerable_remove (walk->container, walk->children[2]);
+      g_containerable_remove (walk->container, walk->children[3]);
+    }
+  else if (childable == walk->children[4])
+    {
+      nested = *walk;
+      nested.n_visited = 0;
+      g_containerable_foreach (walk->container, G_CALLBACK (remove_next), &nested);
+      g_assert (nested.n_visited >= 2);
+      g_assert (nested.visited[nested.n_visited - 1] != walk->children[5]);
+    }
+}
+
+static void
+test_foreach (guint    kind,
+              gboolean snapshot)
+{
+  Walk walk;
+
+  init_walk (&walk, kind);
+  g_containerable_foreach (walk.container, G_CALLBACK (remove_siblings), &walk);
+
+  /* A snapshot keeps the removed children alive until the walk ends */
+  if (snapshot)
+    {
+      g_assert (walk.n_visited == N_CHILDREN);
+    }
+  else
+    {
+      g_assert (walk.n_visited == 4);
+      g_assert (walk.visited[0] == walk.children[0]);
+      g_assert (walk.visited[1] == walk.children[2]);
+      g_assert (walk.visited[2] == walk.children[4]);
+      g_assert (walk.visited[3] == walk.children[6]);
+    }
+
+  g_assert (walk.n_finalized == 5);
+  g_assert (g_containerable_n_children (walk.container) == 3);
+  g_assert (g_containerable_get_nth (walk.container, 0) == walk.children[0]);
+  g_assert (g_containerable_get_nth (walk.container, 1) == walk.children[4]);
+  g_assert (g_containerable_get_nth (walk.container, 2) == walk.children[6]);
+
+  g_object_unref (walk.container);
+  g_assert (walk.n_finalized == N_CHILDREN);
+}
+
+static void
+ping_remove_next (GChildable *childable,
+                  Walk       *walk)
+{
+  visit (walk, childable);
+
+  if (childable == walk->children[0])
+    g_containerable_remove (walk->container, walk->children[1]);
+}
+
+static void
+test_propagate (guint    kind,
+                gboolean snapshot)
+{
+  Walk  walk;
+  guint n;
+
+  init_walk (&walk, kind);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    g_signal_connect (walk.children[n], "ping",
+                      G_CALLBACK (ping_remove_next), &walk);
+
+  g_containerable_propagate_by_name (walk.container, "ping");
+
+  g_assert (walk.n_visited == (snapshot ? N_CHILDREN : N_CHILDREN - 1));
+  g_assert (walk.visited[1] == walk.children[snapshot ? 1 : 2]);
+  g_assert (walk.n_finalized == 1);
+
+  g_object_unref (walk.container);
+  g_assert (walk.n_finalized == N_CHILDREN);
+}
+
+static void
+parent_set_remove_next (GChildable     *childable,
+                        GContainerable *old_parent,
+                        Walk           *walk)
+{
+  if (old_parent == walk->container)
+    g_containerable_remove (walk->container, walk->children[1]);
+}
+
+static void
+test_dispose (guint kind)
+{
+  Walk walk;
+
+  init_walk (&walk, kind);
+  g_signal_connect (walk.children[0], "parent-set",
+                    G_CALLBACK (parent_set_remove_next), &walk);
+
+  g_object_unref (walk.container);
+  g_assert (walk.n_finalized == N_CHILDREN);
+}
+
+int
+main (int argc, char *argv[])
+{
+  guint kind;
+
+  g_type_init ();
+
+  g_signal_new ("ping", G_TYPE_CHILD, G_SIGNAL_RUN_LAST,
+                0, NULL, NULL, g_cclosure_marshal_VOID__VOID,
+                G_TYPE_NONE, 0);
+
+  /* Kind 1 is the thread safe GContainer */
+  for (kind = 0; kind < 6; ++ kind)
+    {
+      test_foreach (kind, kind == 1);
+      test_propagate (kind, kind == 1);
+      test_dispose (kind);
+    }
+
+  return 0;
+}
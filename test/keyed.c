@@ -0,0 +1,163 @@
+/* libgcontainer - GKeyedContainer test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * GKeyedContainer keys: a child whose key is missing or yet used must be
+ * refused with a warning, without being parented or referenced, and the
+ * index must follow the children through additions and removals, even
+ * when the key of a child changes while it is inside the container.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_CHILDREN	5
+
+
+static gchar *
+get_key (GChildable *childable,
+         gpointer    user_data)
+{
+  return g_strdup (g_object_get_data ((GObject *) childable, "key"));
+}
+
+static void
+count_warning (const gchar    *log_domain,
+               GLogLevelFlags  log_level,
+               const gchar    *message,
+               gpointer        user_data)
+{
+  ++ *(guint *) user_data;
+}
+
+static GChildable *
+new_child (const gchar *key)
+{
+  GObject *child;
+
+  child = g_object_ref_sink (g_child_new ());
+  g_object_set_data_full (child, "key", g_strdup (key), g_free);
+
+  return (GChildable *) child;
+}
+
+/* Checks that @childable has been refused by @keyed_container */
+static void
+check_refused (GKeyedContainer *keyed_container,
+               GChildable      *childable,
+               guint            n_children)
+{
+  g_assert (g_childable_get_parent (childable) == NULL);
+  g_assert (! g_containerable_contains ((GContainerable *) keyed_container,
+                                        childable));
+  g_assert (G_OBJECT (childable)->ref_count == 1);
+  g_assert (g_containerable_n_children ((GContainerable *) keyed_container) ==
+            n_children);
+}
+
+int
+main (int argc, char *argv[])
+{
+  GKeyedContainer *keyed_container;
+  GContainerable  *containerable;
+  GChildable      *children[N_CHILDREN];
+  GChildable      *batch[2];
+  guint            n, n_warnings;
+
+  g_type_init ();
+
+  n_warnings = 0;
+  g_log_set_handler (NULL, G_LOG_LEVEL_WARNING, count_warning, &n_warnings);
+
+  keyed_container = g_object_ref_sink (g_keyed_container_new_with_func (get_key,
+                                                                      NULL, NULL));
+  containerable = (GContainerable *) keyed_container;
+
+  children[0] = new_child ("a");
+  children[1] = new_child ("b");
+  children[2] = new_child ("a");
+  children[3] = new_child (NULL);
+  children[4] = new_child ("c");
+
+  g_containerable_add (containerable, children[0]);
+  g_containerable_add (containerable, children[1]);
+  g_assert (n_warnings == 0);
+  g_assert (g_keyed_container_lookup (keyed_container, "a") == children[0]);
+  g_assert (g_keyed_container_lookup (keyed_container, "b") == children[1]);
+  g_assert (g_keyed_container_lookup (keyed_container, "c") == NULL);
+
+  /* A duplicate key and a missing key are both refused */
+  g_containerable_add (containerable, children[2]);
+  g_assert (n_warnings == 1);
+  check_refused (keyed_container, children[2], 2);
+  g_assert (g_keyed_container_lookup (keyed_container, "a") == children[0]);
+
+  g_containerable_add (containerable, children[3]);
+  g_assert (n_warnings == 2);
+  check_refused (keyed_container, children[3], 2);
+
+  /* A batch is refused as a whole, also when the duplicate keys are
+   * inside the batch itself */
+  batch[0] = children[4];
+  batch[1] = children[2];
+  g_containerable_add_many (containerable, 2, batch, G_CONTAINERABLE_EMIT_BATCH);
+  g_assert (n_warnings == 3);
+  check_refused (keyed_container, children[4], 2);
+  check_refused (keyed_container, children[2], 2);
+  g_assert (g_keyed_container_lookup (keyed_container, "c") == NULL);
+
+  g_object_set_data_full ((GObject *) children[2], "key", g_strdup ("c"), g_free);
+  g_containerable_add_many (containerable, 2, batch, G_CONTAINERABLE_EMIT_BATCH);
+  g_assert (n_warnings == 4);
+  check_refused (keyed_container, children[4], 2);
+  check_refused (keyed_container, children[2], 2);
+  g_object_set_data_full ((GObject *) children[2], "key", g_strdup ("a"), g_free);
+
+  /* Once the key is released, the same key can be used again */
+  g_containerable_remove (containerable, children[0]);
+  g_assert (g_childable_get_parent (children[0]) == NULL);
+  g_assert (g_keyed_container_lookup (keyed_container, "a") == NULL);
+
+  g_containerable_add (containerable, children[2]);
+  g_assert (g_keyed_container_lookup (keyed_container, "a") == children[2]);
+  g_assert (g_childable_get_parent (children[2]) == containerable);
+  g_assert (g_containerable_get_nth (containerable, 0) == children[1]);
+  g_assert (g_containerable_get_nth (containerable, 1) == children[2]);
+
+  /* The key a child had when added is the one released on removal */
+  g_object_set_data_full ((GObject *) children[2], "key", g_strdup ("z"), g_free);
+  g_containerable_remove (containerable, children[2]);
+  g_assert (g_keyed_container_lookup (keyed_container, "a") == NULL);
+  g_assert (g_keyed_container_lookup (keyed_container, "z") == NULL);
+
+  g_assert (n_warnings == 4);
+
+  g_object_unref (keyed_container);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      g_assert (g_childable_get_parent (children[n]) == NULL);
+      g_assert (G_OBJECT (children[n])->ref_count == 1);
+      g_object_unref (children[n]);
+    }
+
+  return 0;
+}
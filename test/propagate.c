@@ -0,0 +1,197 @@
+/* libgcontainer - Deep propagation test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * Deep propagation on trees with cycles: every descendant must be
+ * emitted exactly once, in pre-order or post-order, the container the
+ * propagation starts from must never be emitted, and only the instances
+ * of the type owning the signal must be emitted.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+static void
+log_emission (GObject   *object,
+              GPtrArray *log)
+{
+  g_ptr_array_add (log, object);
+}
+
+/* Adds a new child to the container it is emitted on, the first time:
+ * in pre-order the new child must be emitted too */
+static void
+add_late_child (GObject    *object,
+                GObject   **late)
+{
+  if (*late != NULL)
+    return;
+
+  *late = g_object_ref_sink (g_child_new ());
+  g_signal_connect (*late, "ping", G_CALLBACK (log_emission),
+                    g_object_get_data (object, "log"));
+  g_containerable_add ((GContainerable *) object, (GChildable *) *late);
+}
+
+static GObject *
+new_node (GObject     *object,
+          GObject     *parent,
+          GPtrArray   *log)
+{
+  g_object_ref_sink (object);
+  g_object_set_data (object, "log", log);
+  g_signal_connect (object, "ping", G_CALLBACK (log_emission), log);
+
+  if (G_IS_CONTAINER (object))
+    g_signal_connect (object, "container-ping", G_CALLBACK (log_emission), log);
+
+  if (parent != NULL)
+    g_containerable_add ((GContainerable *) parent, (GChildable *) object);
+
+  return object;
+}
+
+static void
+check_log (GPtrArray  *log,
+           GObject   **expected)
+{
+  guint n;
+
+  for (n = 0; expected[n] != NULL; ++ n)
+    {
+      g_assert (n < log->len);
+      g_assert (g_ptr_array_index (log, n) == expected[n]);
+    }
+
+  g_assert (n == log->len);
+  g_ptr_array_set_size (log, 0);
+}
+
+int
+main (int argc, char *argv[])
+{
+  GObject   *root, *a, *a1, *b, *b1, *c, *self, *late;
+  GObject   *expected[8];
+  GPtrArray *log;
+  guint      ping, container_ping;
+  gulong     handler;
+
+  g_type_init ();
+
+  ping = g_signal_new ("ping", G_TYPE_CHILD, G_SIGNAL_RUN_LAST,
+                       0, NULL, NULL, g_cclosure_marshal_VOID__VOID,
+                       G_TYPE_NONE, 0);
+  container_ping = g_signal_new ("container-ping", G_TYPE_CONTAINER,
+                                 G_SIGNAL_RUN_LAST,
+                                 0, NULL, NULL, g_cclosure_marshal_VOID__VOID,
+                                 G_TYPE_NONE, 0);
+
+  /* root -> { a -> { a1, root }, b -> { b1 }, c }: root and a are
+   * each the parent of the other, and b is not a GContainer */
+  log = g_ptr_array_new ();
+  root = new_node (g_container_new (), NULL, log);
+  a = new_node (g_container_new (), root, log);
+  a1 = new_node (g_child_new (), a, log);
+  g_containerable_add ((GContainerable *) a, (GChildable *) root);
+  b = new_node (g_bin_new (), root, log);
+  b1 = new_node (g_child_new (), b, log);
+  c = new_node (g_child_new (), root, log);
+
+  g_containerable_propagate_deep ((GContainerable *) root, G_PRE_ORDER, ping, 0);
+  expected[0] = a;
+  expected[1] = a1;
+  expected[2] = b;
+  expected[3] = b1;
+  expected[4] = c;
+  expected[5] = NULL;
+  check_log (log, expected);
+
+  g_containerable_propagate_deep ((GContainerable *) root, G_POST_ORDER, ping, 0);
+  expected[0] = a1;
+  expected[1] = a;
+  expected[2] = b1;
+  expected[3] = b;
+  expected[4] = c;
+  expected[5] = NULL;
+  check_log (log, expected);
+
+  /* Starting from inside the cycle, root is a plain descendant */
+  g_containerable_propagate_deep ((GContainerable *) a, G_PRE_ORDER, ping, 0);
+  expected[0] = a1;
+  expected[1] = root;
+  expected[2] = b;
+  expected[3] = b1;
+  expected[4] = c;
+  expected[5] = NULL;
+  check_log (log, expected);
+
+  /* Only the GContainer instances are emitted, but the walk goes on
+   * through the children of the GBin */
+  g_containerable_propagate_deep ((GContainerable *) a, G_POST_ORDER,
+                                  container_ping, 0);
+  expected[0] = root;
+  expected[1] = NULL;
+  check_log (log, expected);
+
+  /* A container inside itself has no other descendant */
+  self = new_node (g_container_new (), NULL, log);
+  g_containerable_add ((GContainerable *) self, (GChildable *) self);
+  g_containerable_propagate_deep ((GContainerable *) self, G_PRE_ORDER, ping, 0);
+  g_containerable_propagate_deep ((GContainerable *) self, G_POST_ORDER, ping, 0);
+  expected[0] = NULL;
+  check_log (log, expected);
+
+  /* In pre-order the children are collected after the emission */
+  late = NULL;
+  handler = g_signal_connect (a, "ping", G_CALLBACK (add_late_child), &late);
+  g_containerable_propagate_deep ((GContainerable *) root, G_PRE_ORDER, ping, 0);
+  g_signal_handler_disconnect (a, handler);
+  g_assert (late != NULL);
+  expected[0] = a;
+  expected[1] = a1;
+  expected[2] = late;
+  expected[3] = b;
+  expected[4] = b1;
+  expected[5] = c;
+  expected[6] = NULL;
+  check_log (log, expected);
+
+  /* The walk must not leak references */
+  g_assert (root->ref_count == 2 && a->ref_count == 2 && b->ref_count == 2);
+
+  /* Break the cycles, so everything can be released */
+  g_containerable_remove ((GContainerable *) a, (GChildable *) root);
+  g_containerable_remove ((GContainerable *) self, (GChildable *) self);
+  g_object_unref (self);
+
+  g_object_unref (late);
+  g_object_unref (c);
+  g_object_unref (b1);
+  g_object_unref (b);
+  g_object_unref (a1);
+  g_object_unref (a);
+  g_assert (root->ref_count == 1);
+  g_object_unref (root);
+
+  g_ptr_array_free (log, TRUE);
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+/* libgcontainer - GSlot test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * GSlot positions: children inserted at arbitrary positions must shift
+ * the following ones, and every query by position (get_nth, foreach,
+ * g_slot_get_position(), children-changed) must agree on the order.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_CHILDREN	6
+
+
+typedef struct
+{
+  guint position;
+  guint removed;
+  guint added;
+  guint n_changes;
+} Change;
+
+
+static void
+children_changed (GContainerable *containerable,
+                  guint           position,
+                  guint           removed,
+                  guint           added,
+                  Change         *change)
+{
+  change->position = position;
+  change->removed = removed;
+  change->added = added;
+  ++ change->n_changes;
+}
+
+static void
+check_child (GChildable *childable,
+             GPtrArray  *expected)
+{
+  g_assert (g_ptr_array_index (expected, 0) == childable);
+  g_ptr_array_remove_index (expected, 0);
+}
+
+/* Inserts another child at the head while @childable is being inserted */
+static void
+insert_nested (GChildable     *childable,
+               GContainerable *old_parent,
+               GChildable     *nested)
+{
+  g_slot_insert ((GSlot *) g_childable_get_parent (childable), nested, 0);
+}
+
+/* Checks that @slot holds @children, in this order, from every point
+ * of view: @children is a %NULL terminated array */
+static void
+check_order (GSlot       *slot,
+             GChildable **children)
+{
+  GContainerable *containerable;
+  GPtrArray      *expected;
+  guint           n, n_children;
+
+  containerable = (GContainerable *) slot;
+  expected = g_ptr_array_new ();
+
+  for (n_children = 0; children[n_children] != NULL; ++ n_children)
+    g_ptr_array_add (expected, children[n_children]);
+
+  g_assert (g_containerable_n_children (containerable) == n_children);
+
+  for (n = 0; n < n_children; ++ n)
+    {
+      g_assert (g_containerable_get_nth (containerable, n) == children[n]);
+      g_assert (g_slot_get_position (slot, children[n]) == (gint) n);
+      g_assert (g_childable_get_parent (children[n]) == containerable);
+    }
+
+  g_assert (g_containerable_get_nth (containerable, n_children) == NULL);
+
+  g_containerable_foreach (containerable, G_CALLBACK (check_child), expected);
+  g_assert (expected->len == 0);
+
+  g_ptr_array_free (expected, TRUE);
+}
+
+int
+main (int argc, char *argv[])
+{
+  GSlot      *slot;
+  GChildable *children[N_CHILDREN];
+  GChildable *order[N_CHILDREN + 1];
+  Change      change;
+  guint       n;
+
+  g_type_init ();
+
+  slot = g_object_ref_sink (g_slot_new ());
+  change.n_changes = 0;
+  g_signal_connect (slot, "children-changed",
+                    G_CALLBACK (children_changed), &change);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    children[n] = g_object_ref_sink (g_child_new ());
+
+  /* Appending, with g_containerable_add() and out of range positions */
+  g_containerable_add ((GContainerable *) slot, children[0]);
+  g_assert (change.n_changes == 1 && change.position == 0 &&
+            change.removed == 0 && change.added == 1);
+  g_slot_insert (slot, children[1], -1);
+  g_assert (change.position == 1);
+  g_slot_insert (slot, children[2], 100);
+  g_assert (change.position == 2);
+
+  order[0] = children[0];
+  order[1] = children[1];
+  order[2] = children[2];
+  order[3] = NULL;
+  check_order (slot, order);
+
+  /* Inserting at the head and in the middle shifts the others */
+  g_slot_insert (slot, children[3], 0);
+  g_assert (change.n_changes == 4 && change.position == 0 && change.added == 1);
+  g_slot_insert (slot, children[4], 2);
+  g_assert (change.position == 2);
+
+  order[0] = children[3];
+  order[1] = children[0];
+  order[2] = children[4];
+  order[3] = children[1];
+  order[4] = children[2];
+  order[5] = NULL;
+  check_order (slot, order);
+
+  /* The position of g_slot_insert() is used only once: a later
+   * g_containerable_add() appends again */
+  g_containerable_add ((GContainerable *) slot, children[5]);
+  g_assert (change.position == 5);
+
+  /* Removing by position and by child shifts the others back */
+  g_slot_remove_nth (slot, 1);
+  g_assert (change.n_changes == 7 && change.position == 1 &&
+            change.removed == 1 && change.added == 0);
+  g_assert (g_childable_get_parent (children[0]) == NULL);
+  g_containerable_remove ((GContainerable *) slot, children[1]);
+  g_assert (change.position == 2 && change.removed == 1);
+
+  order[0] = children[3];
+  order[1] = children[4];
+  order[2] = children[2];
+  order[3] = children[5];
+  order[4] = NULL;
+  check_order (slot, order);
+
+  g_assert (g_slot_get_position (slot, children[0]) == -1);
+
+  g_slot_insert (slot, children[0], 1);
+
+  order[0] = children[3];
+  order[1] = children[0];
+  order[2] = children[4];
+  order[3] = children[2];
+  order[4] = children[5];
+  order[5] = NULL;
+  check_order (slot, order);
+
+  /* Every insertion keeps its own position, also when nested */
+  g_containerable_remove ((GContainerable *) slot, children[5]);
+  g_containerable_remove ((GContainerable *) slot, children[0]);
+  g_signal_connect (children[1], "parent-set",
+                    G_CALLBACK (insert_nested), children[5]);
+  g_slot_insert (slot, children[1], 2);
+  g_signal_handlers_disconnect_by_func (children[1], insert_nested, children[5]);
+
+  order[0] = children[5];
+  order[1] = children[3];
+  order[2] = children[4];
+  order[3] = children[1];
+  order[4] = children[2];
+  order[5] = NULL;
+  check_order (slot, order);
+
+  g_object_unref (slot);
+
+  /* Destroying the slot must have dropped its references */
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      g_assert (g_childable_get_parent (children[n]) == NULL);
+      g_assert (G_OBJECT (children[n])->ref_count == 1);
+      g_object_unref (children[n]);
+    }
+
+  return 0;
+}
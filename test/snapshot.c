@@ -0,0 +1,230 @@
+/* libgcontainer - Snapshot test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * Children snapshot: a #GContainer must give the same array to all the
+ * callers until it is modified, any addition or removal must invalidate
+ * it, and an invalidated array must stay valid and unchanged, keeping
+ * its children alive, until its last reference is dropped.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_CHILDREN	8
+
+
+static void
+count_finalized (guint   *n_finalized,
+                 GObject *where_the_object_was)
+{
+  ++ *n_finalized;
+}
+
+/* Checks @snapshot holds exactly the @n_children objects in @children */
+static void
+check_snapshot (GPtrArray   *snapshot,
+                guint        n_children,
+                GChildable **children)
+{
+  guint n;
+
+  g_assert (snapshot != NULL);
+  g_assert (snapshot->len == n_children);
+
+  for (n = 0; n < n_children; ++ n)
+    g_assert (g_ptr_array_index (snapshot, n) == children[n]);
+}
+
+/* Gets the snapshot of @containerable twice, checking the array is
+ * shared and matches @children: one reference is returned */
+static GPtrArray *
+shared_snapshot (GContainerable *containerable,
+                 guint           n_children,
+                 GChildable    **children)
+{
+  GPtrArray *snapshot, *again;
+  guint      n;
+
+  snapshot = g_containerable_get_children_snapshot (containerable);
+  check_snapshot (snapshot, n_children, children);
+
+  again = g_containerable_get_children_snapshot (containerable);
+  g_assert (again == snapshot);
+  g_ptr_array_unref (again);
+
+  /* get_nth() reads the cached array coherently */
+  for (n = 0; n < n_children; ++ n)
+    g_assert (g_containerable_get_nth (containerable, n) == children[n]);
+  g_assert (g_containerable_get_nth (containerable, n_children) == NULL);
+
+  return snapshot;
+}
+
+static void
+test_container (gboolean thread_safe)
+{
+  GContainerable *container, *other;
+  GChildable     *children[N_CHILDREN];
+  GPtrArray      *snapshot, *stale;
+  guint           n, n_finalized;
+
+  container = g_object_ref_sink (g_object_new (G_TYPE_CONTAINER,
+                                               "thread-safe", thread_safe,
+                                               NULL));
+  other = g_object_ref_sink (g_container_new ());
+  n_finalized = 0;
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      children[n] = (GChildable *) g_child_new ();
+      g_object_weak_ref ((GObject *) children[n],
+                         (GWeakNotify) count_finalized, &n_finalized);
+    }
+
+  /* The empty container has an empty snapshot too */
+  snapshot = shared_snapshot (container, 0, children);
+  stale = snapshot;
+
+  /* add */
+  g_containerable_add (container, children[0]);
+  snapshot = shared_snapshot (container, 1, children);
+  g_assert (snapshot != stale);
+  check_snapshot (stale, 0, children);
+  g_ptr_array_unref (stale);
+  stale = snapshot;
+
+  /* add_many, both in batch and one by one */
+  g_containerable_add_many (container, 3, children + 1,
+                            G_CONTAINERABLE_EMIT_BATCH);
+  snapshot = shared_snapshot (container, 4, children);
+  g_assert (snapshot != stale);
+  check_snapshot (stale, 1, children);
+  g_ptr_array_unref (stale);
+  stale = snapshot;
+
+  g_containerable_add_many (container, N_CHILDREN - 4, children + 4,
+                            G_CONTAINERABLE_EMIT_EACH);
+  snapshot = shared_snapshot (container, N_CHILDREN, children);
+  g_assert (snapshot != stale);
+  check_snapshot (stale, 4, children);
+  g_ptr_array_unref (stale);
+  stale = snapshot;
+
+  /* The snapshot holds its own reference on every child, so removing
+   * the last child does not release it until the array is dropped */
+  g_containerable_remove (container, children[N_CHILDREN - 1]);
+  g_assert (n_finalized == 0);
+  g_assert (G_OBJECT (children[N_CHILDREN - 1])->ref_count == 1);
+  snapshot = shared_snapshot (container, N_CHILDREN - 1, children);
+  g_assert (snapshot != stale);
+  check_snapshot (stale, N_CHILDREN, children);
+  g_ptr_array_unref (stale);
+  g_assert (n_finalized == 1);
+  stale = snapshot;
+
+  /* remove_many */
+  g_containerable_remove_many (container, 2, children + N_CHILDREN - 3,
+                               G_CONTAINERABLE_EMIT_BATCH);
+  g_assert (n_finalized == 1);
+  snapshot = shared_snapshot (container, N_CHILDREN - 3, children);
+  g_assert (snapshot != stale);
+  check_snapshot (stale, N_CHILDREN - 1, children);
+  g_ptr_array_unref (stale);
+  g_assert (n_finalized == 3);
+  stale = snapshot;
+
+  /* move invalidates both the containers */
+  snapshot = shared_snapshot (other, 0, children);
+  g_containerable_move (other, children[0]);
+  g_assert (g_childable_get_parent (children[0]) == other);
+  check_snapshot (snapshot, 0, children);
+  g_ptr_array_unref (snapshot);
+  snapshot = shared_snapshot (other, 1, children);
+  g_ptr_array_unref (snapshot);
+
+  snapshot = shared_snapshot (container, N_CHILDREN - 4, children + 1);
+  g_assert (snapshot != stale);
+  check_snapshot (stale, N_CHILDREN - 3, children);
+  g_ptr_array_unref (snapshot);
+
+  g_containerable_move (container, children[0]);
+  g_assert (g_childable_get_parent (children[0]) == container);
+  snapshot = shared_snapshot (other, 0, children);
+  g_ptr_array_unref (snapshot);
+
+  snapshot = g_containerable_get_children_snapshot (container);
+  g_assert (snapshot->len == N_CHILDREN - 3);
+  g_assert (g_ptr_array_index (snapshot, N_CHILDREN - 4) == children[0]);
+  g_ptr_array_unref (snapshot);
+  g_assert (n_finalized == 3);
+
+  /* Destroying the container with a snapshot still around keeps
+   * the children alive until the array is released */
+  g_object_unref (container);
+  g_assert (n_finalized == 3);
+  g_ptr_array_unref (stale);
+  g_assert (n_finalized == N_CHILDREN);
+
+  g_object_unref (other);
+}
+
+/* Containers not caching the snapshot build a new array every time */
+static void
+test_default (void)
+{
+  GContainerable *bin;
+  GChildable     *child;
+  GPtrArray      *snapshot, *again;
+
+  bin = g_object_ref_sink (g_bin_new ());
+  child = (GChildable *) g_child_new ();
+  g_containerable_add (bin, child);
+
+  snapshot = g_containerable_get_children_snapshot (bin);
+  again = g_containerable_get_children_snapshot (bin);
+  check_snapshot (snapshot, 1, &child);
+  check_snapshot (again, 1, &child);
+  g_assert (again != snapshot);
+  g_ptr_array_unref (again);
+
+  g_object_ref (child);
+  g_containerable_remove (bin, child);
+  check_snapshot (snapshot, 1, &child);
+  g_assert (G_OBJECT (child)->ref_count == 2);
+  g_ptr_array_unref (snapshot);
+  g_assert (G_OBJECT (child)->ref_count == 1);
+
+  g_object_unref (child);
+  g_object_unref (bin);
+}
+
+int
+main (int argc, char *argv[])
+{
+  g_type_init ();
+
+  test_container (FALSE);
+  test_container (TRUE);
+  test_default ();
+
+  return 0;
+}
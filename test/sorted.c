@@ -0,0 +1,266 @@
+/* libgcontainer - GSortedContainer test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * GSortedContainer order: the children must be kept sorted on addition,
+ * found with a binary search and moved to their new place, with the
+ * proper children-changed notification, when their sort property changes.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_CHILDREN	6
+
+
+/* A GChild with an integer "rank" property to sort on */
+
+typedef struct
+{
+  GChild	 child;
+  gint		 rank;
+} Ranked;
+
+typedef struct
+{
+  GChildClass	 parent_class;
+} RankedClass;
+
+enum
+{
+  PROP_0,
+  PROP_RANK
+};
+
+typedef struct
+{
+  guint position;
+  guint removed;
+  guint added;
+  guint n_changes;
+} Change;
+
+
+G_DEFINE_TYPE (Ranked, ranked, G_TYPE_CHILD)
+
+
+static void
+ranked_set_property (GObject      *object,
+                     guint         prop_id,
+                     const GValue *value,
+                     GParamSpec   *pspec)
+{
+  if (prop_id == PROP_RANK)
+    ((Ranked *) object)->rank = g_value_get_int (value);
+  else
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+}
+
+static void
+ranked_get_property (GObject    *object,
+                     guint       prop_id,
+                     GValue     *value,
+                     GParamSpec *pspec)
+{
+  if (prop_id == PROP_RANK)
+    g_value_set_int (value, ((Ranked *) object)->rank);
+  else
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+}
+
+static void
+ranked_class_init (RankedClass *klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->set_property = ranked_set_property;
+  gobject_class->get_property = ranked_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_RANK,
+                                   g_param_spec_int ("rank", "Rank", "Rank",
+                                                     G_MININT, G_MAXINT, 0,
+                                                     G_PARAM_READWRITE));
+}
+
+static void
+ranked_init (Ranked *ranked)
+{
+}
+
+static gint
+compare_ranked (gconstpointer a,
+                gconstpointer b,
+                gpointer      user_data)
+{
+  return ((const Ranked *) a)->rank - ((const Ranked *) b)->rank;
+}
+
+static gint
+compare_rank (gconstpointer a,
+              gconstpointer b,
+              gpointer      user_data)
+{
+  return ((const Ranked *) a)->rank - GPOINTER_TO_INT (b);
+}
+
+static void
+children_changed (GContainerable *containerable,
+                  guint           position,
+                  guint           removed,
+                  guint           added,
+                  Change         *change)
+{
+  change->position = position;
+  change->removed = removed;
+  change->added = added;
+  ++ change->n_changes;
+}
+
+static void
+check_ranks (GSortedContainer *sorted_container,
+             const gint       *ranks,
+             guint             n_ranks)
+{
+  GContainerable *containerable;
+  guint           n;
+
+  containerable = (GContainerable *) sorted_container;
+
+  g_assert (g_containerable_n_children (containerable) == n_ranks);
+
+  for (n = 0; n < n_ranks; ++ n)
+    g_assert (((Ranked *) g_containerable_get_nth (containerable, n))->rank == ranks[n]);
+}
+
+static guint
+lower_bound (GSortedContainer *sorted_container,
+             gint              rank)
+{
+  return g_sorted_container_lower_bound (sorted_container, GINT_TO_POINTER (rank),
+                                         compare_rank, NULL);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const gint ranks[N_CHILDREN] = { 5, 1, 3, 3, 9, 7 };
+
+  GSortedContainer *sorted_container;
+  GContainerable   *containerable;
+  GChildable       *children[N_CHILDREN];
+  Change            change;
+  guint             n;
+
+  g_type_init ();
+
+  sorted_container = g_object_ref_sink (g_sorted_container_new ("rank",
+                                                                compare_ranked,
+                                                                NULL, NULL));
+  containerable = (GContainerable *) sorted_container;
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      children[n] = g_object_ref_sink (g_object_new (ranked_get_type (),
+                                                     "rank", ranks[n],
+                                                     NULL));
+      g_containerable_add (containerable, children[n]);
+    }
+
+  /* Children comparing equal are kept in insertion order */
+  {
+    static const gint sorted[] = { 1, 3, 3, 5, 7, 9 };
+    check_ranks (sorted_container, sorted, G_N_ELEMENTS (sorted));
+    g_assert (g_containerable_get_nth (containerable, 1) == children[2]);
+    g_assert (g_containerable_get_nth (containerable, 2) == children[3]);
+  }
+
+  /* The binary searches stop on the first child not less than the key */
+  g_assert (lower_bound (sorted_container, 0) == 0);
+  g_assert (lower_bound (sorted_container, 1) == 0);
+  g_assert (lower_bound (sorted_container, 3) == 1);
+  g_assert (lower_bound (sorted_container, 4) == 3);
+  g_assert (lower_bound (sorted_container, 9) == 5);
+  g_assert (lower_bound (sorted_container, 10) == N_CHILDREN);
+
+  g_assert (g_sorted_container_find (sorted_container, GINT_TO_POINTER (3),
+                                     compare_rank, NULL) == children[2]);
+  g_assert (g_sorted_container_find (sorted_container, GINT_TO_POINTER (4),
+                                     compare_rank, NULL) == NULL);
+  g_assert (g_sorted_container_find (sorted_container, GINT_TO_POINTER (10),
+                                     compare_rank, NULL) == NULL);
+
+  change.n_changes = 0;
+  g_signal_connect (sorted_container, "children-changed",
+                    G_CALLBACK (children_changed), &change);
+
+  /* Changing the sort property moves only that child, and the range
+   * between its old and its new place is notified as replaced */
+  g_object_set (children[1], "rank", 8, NULL);
+  {
+    static const gint sorted[] = { 3, 3, 5, 7, 8, 9 };
+    check_ranks (sorted_container, sorted, G_N_ELEMENTS (sorted));
+    g_assert (change.n_changes == 1 && change.position == 0 &&
+              change.removed == 5 && change.added == 5);
+    g_assert (lower_bound (sorted_container, 8) == 4);
+  }
+
+  g_object_set (children[4], "rank", 0, NULL);
+  {
+    static const gint sorted[] = { 0, 3, 3, 5, 7, 8 };
+    check_ranks (sorted_container, sorted, G_N_ELEMENTS (sorted));
+    g_assert (change.n_changes == 2 && change.position == 0 &&
+              change.removed == 6 && change.added == 6);
+  }
+
+  /* A change not affecting the order is not notified */
+  g_object_set (children[0], "rank", 6, NULL);
+  g_assert (change.n_changes == 2);
+  g_assert (g_containerable_get_nth (containerable, 3) == children[0]);
+
+  /* Additions and removals report the sorted position */
+  g_containerable_remove (containerable, children[0]);
+  g_assert (change.n_changes == 3 && change.position == 3 &&
+            change.removed == 1 && change.added == 0);
+  g_assert (g_childable_get_parent (children[0]) == NULL);
+
+  /* A removed child is not followed anymore */
+  g_object_set (children[0], "rank", -1, NULL);
+  g_assert (change.n_changes == 3);
+  {
+    static const gint sorted[] = { 0, 3, 3, 7, 8 };
+    check_ranks (sorted_container, sorted, G_N_ELEMENTS (sorted));
+  }
+
+  g_containerable_add (containerable, children[0]);
+  g_assert (change.n_changes == 4 && change.position == 0 &&
+            change.removed == 0 && change.added == 1);
+
+  g_object_unref (sorted_container);
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      g_assert (g_childable_get_parent (children[n]) == NULL);
+      g_assert (G_OBJECT (children[n])->ref_count == 1);
+      g_object_unref (children[n]);
+    }
+
+  return 0;
+}
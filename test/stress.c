@@ -0,0 +1,174 @@
+/* libgcontainer - Stress test
+ * Copyright (C) 2006, 2008 - Fontana Nicola <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+
+/*
+ * Concurrent moves: some threads keep moving children between thread
+ * safe containers with g_containerable_move() while others check that
+ * a child never appears without a parent. At the end every child must
+ * be inside the container it reports as parent, with no reference
+ * leaked once the containers are gone.
+ */
+
+#include <gcontainer/gcontainer.h>
+
+
+#define N_CONTAINERS	8
+#define N_CHILDREN	256
+#define N_MOVERS	8
+#define N_READERS	4
+#define N_MOVES		100000
+
+
+typedef struct
+{
+  GContainerable *containers[N_CONTAINERS];
+  GChildable     *children[N_CHILDREN];
+  gint            n_movers;
+  gint            n_moved;
+  gint            n_lost;
+} Stress;
+
+
+static gpointer
+mover_thread (Stress *stress)
+{
+  static gint seed = 0;
+
+  GRand      *rand;
+  GChildable *child;
+  guint       n, n_moved, n_lost;
+
+  rand = g_rand_new_with_seed (g_atomic_int_add (&seed, 1));
+  n_moved = n_lost = 0;
+
+  for (n = 0; n < N_MOVES; ++ n)
+    {
+      child = stress->children[g_rand_int_range (rand, 0, N_CHILDREN)];
+
+      if (g_containerable_move (stress->containers[g_rand_int_range (rand, 0, N_CONTAINERS)],
+                                child))
+        ++ n_moved;
+      else
+        ++ n_lost;
+    }
+
+  g_atomic_int_add (&stress->n_moved, n_moved);
+  g_atomic_int_add (&stress->n_lost, n_lost);
+  g_atomic_int_add (&stress->n_movers, -1);
+  g_rand_free (rand);
+  return NULL;
+}
+
+static gpointer
+reader_thread (Stress *stress)
+{
+  GPtrArray *snapshot;
+  guint      n, i;
+
+  while (g_atomic_int_get (&stress->n_movers) > 0)
+    {
+      for (n = 0; n < N_CHILDREN; ++ n)
+        g_assert (g_childable_get_parent (stress->children[n]) != NULL);
+
+      for (n = 0; n < N_CONTAINERS; ++ n)
+        {
+          snapshot = g_containerable_get_children_snapshot (stress->containers[n]);
+
+          for (i = 0; i < snapshot->len; ++ i)
+            g_assert (g_childable_get_parent (g_ptr_array_index (snapshot, i)) != NULL);
+
+          g_ptr_array_unref (snapshot);
+        }
+    }
+
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  Stress      stress;
+  GThread    *movers[N_MOVERS];
+  GThread    *readers[N_READERS];
+  GPtrArray  *snapshot;
+  GObject    *child;
+  guint       n, i, n_children;
+
+  g_type_init ();
+
+  for (n = 0; n < N_CONTAINERS; ++ n)
+    stress.containers[n] = g_object_ref_sink (g_object_new (G_TYPE_CONTAINER,
+                                                            "thread-safe", TRUE,
+                                                            NULL));
+
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      child = g_object_ref_sink (g_child_new ());
+      stress.children[n] = G_CHILDABLE (child);
+      g_containerable_add (stress.containers[n % N_CONTAINERS], stress.children[n]);
+    }
+
+  stress.n_movers = N_MOVERS;
+  stress.n_moved = 0;
+  stress.n_lost = 0;
+
+  for (n = 0; n < N_MOVERS; ++ n)
+    movers[n] = g_thread_new ("mover", (GThreadFunc) mover_thread, &stress);
+  for (n = 0; n < N_READERS; ++ n)
+    readers[n] = g_thread_new ("reader", (GThreadFunc) reader_thread, &stress);
+
+  for (n = 0; n < N_MOVERS; ++ n)
+    g_thread_join (movers[n]);
+  for (n = 0; n < N_READERS; ++ n)
+    g_thread_join (readers[n]);
+
+  /* Every child must be exactly where its parent says */
+  n_children = 0;
+  for (n = 0; n < N_CONTAINERS; ++ n)
+    {
+      snapshot = g_containerable_get_children_snapshot (stress.containers[n]);
+
+      for (i = 0; i < snapshot->len; ++ i)
+        g_assert (g_childable_get_parent (g_ptr_array_index (snapshot, i)) ==
+                  stress.containers[n]);
+
+      n_children += snapshot->len;
+      g_ptr_array_unref (snapshot);
+    }
+
+  g_assert (n_children == N_CHILDREN);
+
+  g_print ("%d moves done, %d lost to a concurrent move\n",
+           stress.n_moved, stress.n_lost);
+
+  for (n = 0; n < N_CONTAINERS; ++ n)
+    g_object_unref (stress.containers[n]);
+
+  /* Destroying the containers must have dropped any other reference */
+  for (n = 0; n < N_CHILDREN; ++ n)
+    {
+      g_assert (g_childable_get_parent (stress.children[n]) == NULL);
+      g_assert (G_OBJECT (stress.children[n])->ref_count == 1);
+      g_object_unref (stress.children[n]);
+    }
+
+  return 0;
+}